@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "rml/RadeonML_graph.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <stdexcept>
@@ -37,10 +39,53 @@ THE SOFTWARE.
 #include <utility>
 #include <vector>
 
+#if defined(__has_include)
+#    if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#        if __has_include(<coroutine>)
+#            include <coroutine>
+#        endif
+#        if __has_include(<span>)
+#            include <span>
+#        endif
+#    endif
+#endif
+
 #define RML_CHECK_STATUS(OP) ::rml::details::CheckStatus(OP == RML_OK, #OP)
 
+// Also used by the other C++ API headers, so it is not undefined at the end of the file
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#    define RML_EXCEPTIONS_ENABLED 1
+#else
+#    define RML_EXCEPTIONS_ENABLED 0
+#endif
+
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+#    define RML_COROUTINES_ENABLED 1
+#else
+#    define RML_COROUTINES_ENABLED 0
+#endif
+
 namespace rml {
 
+/**
+ * N-dimensional box inside a tensor.
+ *
+ * Axes order corresponds to the tensor data layout. Offsets and extents of axes beyond
+ * the tensor rank must be zero.
+ */
+struct TensorRegion
+{
+    /**
+     * Index of the first region element along each axis.
+     */
+    uint32_t offset[RML_TENSOR_MAX_RANK];
+
+    /**
+     * Number of region elements along each axis.
+     */
+    uint32_t extent[RML_TENSOR_MAX_RANK];
+};
+
 namespace details {
 
 template<class T, class HandleType>
@@ -99,6 +144,145 @@ protected:
     HandleType m_handle = nullptr;
 };
 
+/**
+ * Returns the number of tensor dimensions, i.e. the number of leading non-zero dimensions.
+ */
+inline size_t GetTensorRank(const rml_tensor_info& info)
+{
+    size_t rank = 0;
+    while (rank < RML_TENSOR_MAX_RANK && info.shape[rank] != 0)
+    {
+        ++rank;
+    }
+    return rank;
+}
+
+/**
+ * Returns the number of region elements along the first @p rank axes,
+ * zero if any of the extents is zero.
+ */
+inline size_t GetRegionSize(const TensorRegion& region, size_t rank)
+{
+    size_t size = 1;
+    for (size_t i = 0; i < rank; i++)
+    {
+        size *= region.extent[i];
+    }
+    return size;
+}
+
+/**
+ * Converts element strides of a host buffer holding a region to byte strides.
+ * Null element strides mean a densely packed region.
+ */
+inline void GetRegionByteStrides(const TensorRegion& region,
+                                 size_t rank,
+                                 size_t element_size,
+                                 const size_t* element_strides,
+                                 size_t* byte_strides)
+{
+    size_t stride = element_size;
+    for (size_t i = rank; i-- > 0;)
+    {
+        byte_strides[i] = element_strides != nullptr ? element_strides[i] * element_size : stride;
+        stride *= region.extent[i];
+    }
+}
+
+inline void CopyRegion(size_t rank,
+                       const uint32_t* extent,
+                       size_t element_size,
+                       const char* src,
+                       const size_t* src_strides,
+                       char* dst,
+                       const size_t* dst_strides)
+{
+    if (rank == 0)
+    {
+        std::memcpy(dst, src, element_size);
+        return;
+    }
+    if (rank == 1)
+    {
+        if (src_strides[0] == element_size && dst_strides[0] == element_size)
+        {
+            std::memcpy(dst, src, extent[0] * element_size);
+            return;
+        }
+        for (uint32_t i = 0; i < extent[0]; i++)
+        {
+            std::memcpy(dst + i * dst_strides[0], src + i * src_strides[0], element_size);
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < extent[0]; i++)
+    {
+        CopyRegion(rank - 1,
+                   extent + 1,
+                   element_size,
+                   src + i * src_strides[0],
+                   src_strides + 1,
+                   dst + i * dst_strides[0],
+                   dst_strides + 1);
+    }
+}
+
+/**
+ * Throws an exception or, if exceptions are disabled, prints its message and aborts.
+ */
+template<class E>
+[[noreturn]] void Throw(const E& exception)
+{
+#if RML_EXCEPTIONS_ENABLED
+    throw exception;
+#else
+    std::fprintf(stderr, "%s\n", exception.what());
+    std::abort();
+#endif
+}
+
+/**
+ * Computes byte strides of a densely packed tensor along the region axes and returns
+ * the byte offset of the first region element.
+ * Checks that the region is inside the tensor and the element size matches the tensor data.
+ */
+inline size_t GetRegionByteOffset(const TensorRegion& region,
+                                  const rml_tensor_info& info,
+                                  size_t rank,
+                                  size_t element_size,
+                                  size_t data_size,
+                                  size_t* byte_strides)
+{
+    for (size_t i = rank; i < RML_TENSOR_MAX_RANK; i++)
+    {
+        if (region.offset[i] != 0 || region.extent[i] != 0)
+        {
+            Throw(std::runtime_error("Region axis " + std::to_string(i) +
+                                     " is beyond the tensor rank " + std::to_string(rank)));
+        }
+    }
+    size_t stride = element_size;
+    size_t offset = 0;
+    for (size_t i = rank; i-- > 0;)
+    {
+        if (size_t(region.offset[i]) + region.extent[i] > info.shape[i])
+        {
+            Throw(std::runtime_error("Region is out of the tensor bounds along axis " +
+                                     std::to_string(i)));
+        }
+        byte_strides[i] = stride;
+        offset += region.offset[i] * stride;
+        stride *= info.shape[i];
+    }
+    if (stride != data_size)
+    {
+        Throw(std::runtime_error("Region element size does not match the tensor: " +
+                                 std::to_string(stride) + " bytes, expected " +
+                                 std::to_string(data_size)));
+    }
+    return offset;
+}
+
 inline void CheckStatus(bool status, const char* op_name)
 {
     if (!status)
@@ -107,12 +291,122 @@ inline void CheckStatus(bool status, const char* op_name)
         const auto end_pos = func_name.find('(');
         func_name.erase(end_pos != std::string::npos ? end_pos : func_name.size());
 
-        throw std::runtime_error(func_name + " failed: " + rmlGetLastError());
+        Throw(std::runtime_error(func_name + " failed: " + rmlGetLastError()));
     }
 }
 
 } // namespace details
 
+#if RML_COROUTINES_ENABLED
+
+/**
+ * Runs awaited operations on the awaiting thread, which is blocked until they complete.
+ *
+ * A custom executor is any copyable callable accepting a std::function<void()> task,
+ * which must run the task exactly once, e.g. on a thread pool. The task runs the blocking
+ * operation and then resumes the awaiting coroutine on the same thread.
+ */
+struct InlineExecutor
+{
+    void operator()(const std::function<void()>& task) const { task(); }
+};
+
+namespace details {
+
+/**
+ * Awaitable blocking library operation.
+ *
+ * The operation is submitted to the executor, so the awaiting thread is not blocked unless
+ * the executor runs it inline. The error message is taken on the thread running the
+ * operation, right after it fails.
+ *
+ * @tparam Func     A callable running the operation, accepting a string for a custom error
+ *                  message and returning the operation status.
+ * @tparam Executor A callable running a task, see InlineExecutor.
+ */
+template<class Func, class Executor>
+class AsyncOperation
+{
+public:
+    AsyncOperation(const char* op_name, Func func, Executor executor)
+        : m_op_name(op_name), m_func(std::move(func)), m_executor(std::move(executor))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // 'this' and m_executor may be destroyed by the resumed coroutine
+        Executor executor = m_executor;
+        executor([this, handle] {
+            m_status = m_func(m_error);
+            if (m_status != RML_OK && m_error.empty())
+            {
+                m_error = rmlGetLastError();
+            }
+            handle.resume();
+        });
+    }
+
+    void await_resume() const
+    {
+        if (m_status != RML_OK)
+        {
+            Throw(std::runtime_error(std::string(m_op_name) + " failed: " + m_error));
+        }
+    }
+
+private:
+    const char* m_op_name;
+    Func m_func;
+    Executor m_executor;
+    rml_status m_status = RML_OK;
+    std::string m_error;
+};
+
+template<class Func, class Executor>
+AsyncOperation<Func, Executor> MakeAsyncOperation(const char* op_name,
+                                                  Func func,
+                                                  Executor executor)
+{
+    return {op_name, std::move(func), std::move(executor)};
+}
+
+/**
+ * Copies data between a tensor and a host buffer of the tensor data size.
+ */
+inline rml_status CopyTensorData(rml_tensor tensor,
+                                 size_t size,
+                                 void* dst,
+                                 const void* src,
+                                 std::string& error)
+{
+    void* data = nullptr;
+    size_t data_size = 0;
+    rml_status status = rmlMapTensor(tensor, &data, &data_size);
+    if (status != RML_OK)
+    {
+        return status;
+    }
+    if (data_size != size)
+    {
+        rmlUnmapTensor(tensor, data);
+        error = "Bad buffer size: " + std::to_string(size) + ", expected " +
+                std::to_string(data_size);
+        return RML_ERROR_BAD_PARAMETER;
+    }
+    std::memcpy(dst != nullptr ? dst : data, src != nullptr ? src : data, size);
+    return rmlUnmapTensor(tensor, data);
+}
+
+} // namespace details
+
+#endif
+
+template<class T>
+class MappedTensor;
+
 class Tensor : public details::Wrapper<Tensor, rml_tensor>
 {
 public:
@@ -138,28 +432,24 @@ public:
     template<class T>
     void Write(const T& src) const
     {
-        size_t byte_size = 0;
-        void* ptr = Map(&byte_size);
-        size_t size = byte_size / sizeof(typename T::value_type);
-        if (size != src.size())
+        MappedTensor<typename T::value_type> mapped(*this);
+        if (mapped.size() != src.size())
         {
-            Unmap(ptr);
-            throw std::runtime_error("Bad source data size: " + std::to_string(src.size()) +
-                                     ", expected " + std::to_string(size));
+            details::Throw(std::runtime_error("Bad source data size: " +
+                                              std::to_string(src.size()) + ", expected " +
+                                              std::to_string(mapped.size())));
         }
-        std::memcpy(ptr, src.data(), byte_size);
-        Unmap(ptr);
+        std::memcpy(mapped.data(), src.data(), mapped.size_bytes());
+        mapped.Unmap();
     }
 
     template<class T>
     void Read(T& dst) const
     {
-        size_t byte_size = 0;
-        void* ptr = Map(&byte_size);
-        size_t size = byte_size / sizeof(typename T::value_type);
-        dst.resize(size); // TODO: Exception safety
-        std::memcpy(dst.data(), ptr, byte_size);
-        Unmap(ptr);
+        MappedTensor<const typename T::value_type> mapped(*this);
+        dst.resize(mapped.size());
+        std::memcpy(dst.data(), mapped.data(), mapped.size_bytes());
+        mapped.Unmap();
     }
 
     template<class T = uint8_t>
@@ -170,9 +460,224 @@ public:
         return data;
     }
 
+#if RML_COROUTINES_ENABLED
+    /**
+     * Returns an awaitable reading the tensor data into a container of the tensor data size.
+     * The data is copied by a task submitted to the executor, the container must stay alive
+     * until the awaiting coroutine is resumed.
+     */
+    template<class T, class Executor = InlineExecutor>
+    auto ReadAsync(T& dst, Executor executor = {}) const
+    {
+        rml_tensor handle = m_handle;
+        void* data = dst.data();
+        size_t byte_size = dst.size() * sizeof(typename T::value_type);
+        return details::MakeAsyncOperation(
+            "Tensor::ReadAsync",
+            [=](std::string& error) {
+                return details::CopyTensorData(handle, byte_size, data, nullptr, error);
+            },
+            std::move(executor));
+    }
+
+    /**
+     * Returns an awaitable writing the tensor data from a container of the tensor data size.
+     * The data is copied by a task submitted to the executor, the container must stay alive
+     * until the awaiting coroutine is resumed.
+     */
+    template<class T, class Executor = InlineExecutor>
+    auto WriteAsync(const T& src, Executor executor = {}) const
+    {
+        rml_tensor handle = m_handle;
+        const void* data = src.data();
+        size_t byte_size = src.size() * sizeof(typename T::value_type);
+        return details::MakeAsyncOperation(
+            "Tensor::WriteAsync",
+            [=](std::string& error) {
+                return details::CopyTensorData(handle, byte_size, nullptr, data, error);
+            },
+            std::move(executor));
+    }
+#endif
+
+    /**
+     * Writes a region of the tensor, keeping other tensor data.
+     *
+     * The whole tensor is mapped, only the region elements are copied.
+     * Nothing is done if the region is empty along any axis within the tensor rank.
+     *
+     * @param region      A region to write, extents of axes beyond the tensor rank are zero.
+     * @param src         Source data with elements of the tensor data type.
+     * @param src_strides Optional distances between adjacent source elements along each
+     *                    region axis, in elements. If null, the source is densely packed.
+     */
+    template<class T>
+    void WriteRegion(const TensorRegion& region,
+                     const T* src,
+                     const size_t* src_strides = nullptr) const
+    {
+        rml_tensor_info info = Info();
+        size_t rank = details::GetTensorRank(info);
+        if (details::GetRegionSize(region, rank) == 0)
+        {
+            return;
+        }
+        size_t src_byte_strides[RML_TENSOR_MAX_RANK] = {};
+        details::GetRegionByteStrides(region, rank, sizeof(T), src_strides, src_byte_strides);
+
+        MappedTensor<T> mapped(*this);
+        size_t strides[RML_TENSOR_MAX_RANK] = {};
+        size_t offset = details::GetRegionByteOffset(
+            region, info, rank, sizeof(T), mapped.size_bytes(), strides);
+        details::CopyRegion(rank,
+                            region.extent,
+                            sizeof(T),
+                            reinterpret_cast<const char*>(src),
+                            src_byte_strides,
+                            reinterpret_cast<char*>(mapped.data()) + offset,
+                            strides);
+        mapped.Unmap();
+    }
+
+    /**
+     * Reads a region of the tensor.
+     *
+     * The whole tensor is mapped, only the region elements are copied.
+     * Nothing is done if the region is empty along any axis within the tensor rank.
+     *
+     * @param region      A region to read, extents of axes beyond the tensor rank are zero.
+     * @param dst         Destination for elements of the tensor data type.
+     * @param dst_strides Optional distances between adjacent destination elements along each
+     *                    region axis, in elements. If null, the destination is densely packed.
+     */
+    template<class T>
+    void ReadRegion(const TensorRegion& region,
+                    T* dst,
+                    const size_t* dst_strides = nullptr) const
+    {
+        rml_tensor_info info = Info();
+        size_t rank = details::GetTensorRank(info);
+        if (details::GetRegionSize(region, rank) == 0)
+        {
+            return;
+        }
+        size_t dst_byte_strides[RML_TENSOR_MAX_RANK] = {};
+        details::GetRegionByteStrides(region, rank, sizeof(T), dst_strides, dst_byte_strides);
+
+        MappedTensor<const T> mapped(*this);
+        size_t strides[RML_TENSOR_MAX_RANK] = {};
+        size_t offset = details::GetRegionByteOffset(
+            region, info, rank, sizeof(T), mapped.size_bytes(), strides);
+        details::CopyRegion(rank,
+                            region.extent,
+                            sizeof(T),
+                            reinterpret_cast<const char*>(mapped.data()) + offset,
+                            strides,
+                            reinterpret_cast<char*>(dst),
+                            dst_byte_strides);
+        mapped.Unmap();
+    }
+
+    template<class T>
+    std::vector<T> ReadRegion(const TensorRegion& region) const
+    {
+        std::vector<T> data(details::GetRegionSize(region, details::GetTensorRank(Info())));
+        ReadRegion(region, data.data());
+        return data;
+    }
+
     static void ReleaseHandle(rml_tensor tensor) { rmlReleaseTensor(tensor); }
 };
 
+/**
+ * A tensor data mapped into the host address space, unmapped upon destruction.
+ *
+ * Use a const element type for read-only access.
+ */
+template<class T>
+class MappedTensor
+{
+public:
+    /**
+     * Maps the whole tensor, see rmlMapTensor().
+     */
+    explicit MappedTensor(const Tensor& tensor) : m_tensor(tensor())
+    {
+        void* data = nullptr;
+        size_t byte_size = 0;
+        RML_CHECK_STATUS(rmlMapTensor(m_tensor, &data, &byte_size));
+        m_data = static_cast<T*>(data);
+        m_size = byte_size / sizeof(T);
+    }
+
+    MappedTensor(MappedTensor&& other) noexcept
+        : m_tensor(other.m_tensor), m_data(other.m_data), m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    MappedTensor& operator=(MappedTensor&& rhs) noexcept
+    {
+        MappedTensor to_release(std::move(*this)); // 'this' is now empty
+        std::swap(m_tensor, rhs.m_tensor);
+        std::swap(m_data, rhs.m_data);
+        std::swap(m_size, rhs.m_size);
+        return *this;
+    }
+
+    MappedTensor(const MappedTensor&) = delete;
+    MappedTensor& operator=(const MappedTensor&) = delete;
+
+    ~MappedTensor()
+    {
+        if (m_data != nullptr)
+        {
+            rmlUnmapTensor(m_tensor, const_cast<void*>(static_cast<const void*>(m_data)));
+        }
+    }
+
+    /**
+     * Unmaps the data before destruction, reporting errors.
+     * Does nothing if the data is already unmapped.
+     */
+    void Unmap()
+    {
+        if (m_data == nullptr)
+        {
+            return;
+        }
+
+        void* data = const_cast<void*>(static_cast<const void*>(m_data));
+        m_data = nullptr;
+        m_size = 0;
+        RML_CHECK_STATUS(rmlUnmapTensor(m_tensor, data));
+    }
+
+    T* data() const { return m_data; }
+
+    size_t size() const { return m_size; }
+
+    size_t size_bytes() const { return m_size * sizeof(T); }
+
+    T* begin() const { return m_data; }
+
+    T* end() const { return m_data + m_size; }
+
+    T& operator[](size_t index) const { return m_data[index]; }
+
+#if defined(__cpp_lib_span)
+    std::span<T> Span() const { return {m_data, m_size}; }
+
+    operator std::span<T>() const { return Span(); }
+#endif
+
+private:
+    rml_tensor m_tensor = nullptr;
+    T* m_data = nullptr;
+    size_t m_size = 0;
+};
+
 class Model : public details::Wrapper<Model, rml_model>
 {
 public:
@@ -268,6 +773,22 @@ public:
 
     void Infer() const { RML_CHECK_STATUS(rmlInfer(m_handle)); }
 
+#if RML_COROUTINES_ENABLED
+    /**
+     * Returns an awaitable running inference by a task submitted to the executor.
+     * Model inputs and outputs must not be changed until the awaiting coroutine is resumed.
+     */
+    template<class Executor = InlineExecutor>
+    auto InferAsync(Executor executor = {}) const
+    {
+        rml_model handle = m_handle;
+        return details::MakeAsyncOperation(
+            "Model::InferAsync",
+            [=](std::string&) { return rmlInfer(handle); },
+            std::move(executor));
+    }
+#endif
+
     void ResetStates() const { RML_CHECK_STATUS(rmlResetModelStates(m_handle)); }
 
     static void ReleaseHandle(rml_model model) { rmlReleaseModel(model); }
@@ -289,6 +810,26 @@ public:
         return op;
     }
 
+    size_t GetOpCount() const { return GetOpsInternal().num_items; }
+
+    rml_op GetOp(size_t index) const
+    {
+        rml_ops ops = GetOpsInternal();
+        if (index >= ops.num_items)
+        {
+            details::Throw(std::out_of_range("Bad operation index: " + std::to_string(index) +
+                                             ", number of operations " +
+                                             std::to_string(ops.num_items)));
+        }
+        return ops.items[index];
+    }
+
+    std::vector<rml_op> GetOps() const
+    {
+        rml_ops ops = GetOpsInternal();
+        return {ops.items, ops.items + ops.num_items};
+    }
+
     std::vector<const char*> GetInputNames() const
     {
         rml_strings input_data = GetInputNamesInternal();
@@ -304,6 +845,13 @@ public:
     static void ReleaseHandle(rml_graph graph) { rmlReleaseGraph(graph); }
 
 private:
+    rml_ops GetOpsInternal() const
+    {
+        rml_ops ops;
+        RML_CHECK_STATUS(rmlGetGraphOperations(m_handle, &ops));
+        return ops;
+    }
+
     rml_strings GetInputNamesInternal() const
     {
         rml_strings input_data;
@@ -319,6 +867,13 @@ private:
     }
 };
 
+inline rml_op_desc GetOpDesc(rml_op op)
+{
+    rml_op_desc desc = {};
+    RML_CHECK_STATUS(rmlGetOperationDesc(op, &desc));
+    return desc;
+}
+
 inline Graph CreateGraph()
 {
     rml_graph graph = NULL;
@@ -394,6 +949,118 @@ inline std::string GetLastError()
     return rmlGetLastError();
 }
 
+/**
+ * Non-throwing API for latency-sensitive code.
+ *
+ * Functions return a Result carrying the operation status instead of throwing.
+ * The error message is not formatted until requested.
+ */
+namespace nothrow {
+
+template<class T>
+class Result;
+
+/**
+ * Status of an operation without a value.
+ */
+template<>
+class Result<void>
+{
+public:
+    Result(rml_status status) noexcept : m_status(status) {}
+
+    explicit operator bool() const noexcept { return m_status == RML_OK; }
+
+    rml_status Status() const noexcept { return m_status; }
+
+    /**
+     * Returns the error message. Must be called from the thread where the operation failed,
+     * before any other RadeonML call on that thread.
+     */
+    const char* Message() const noexcept { return m_status == RML_OK ? "" : rmlGetLastError(); }
+
+private:
+    rml_status m_status;
+};
+
+/**
+ * Status of an operation and a value, valid if the operation is successful.
+ */
+template<class T>
+class Result : public Result<void>
+{
+public:
+    Result(rml_status status, T value) noexcept : Result<void>(status), m_value(std::move(value))
+    {
+    }
+
+    T& Value() & noexcept { return m_value; }
+
+    const T& Value() const& noexcept { return m_value; }
+
+    T&& Value() && noexcept { return std::move(m_value); }
+
+    T& operator*() & noexcept { return m_value; }
+
+    const T& operator*() const& noexcept { return m_value; }
+
+    T* operator->() noexcept { return &m_value; }
+
+    const T* operator->() const noexcept { return &m_value; }
+
+private:
+    T m_value;
+};
+
+inline Result<Tensor> CreateTensor(const Context& context,
+                                   const rml_tensor_info& info,
+                                   rml_access_mode mode) noexcept
+{
+    rml_tensor tensor = nullptr;
+    rml_status status = rmlCreateTensor(context(), &info, mode, &tensor);
+    return {status, Tensor(tensor)};
+}
+
+inline Result<void*> Map(const Tensor& tensor, size_t* size = nullptr) noexcept
+{
+    void* data = nullptr;
+    rml_status status = rmlMapTensor(tensor(), &data, size);
+    return {status, data};
+}
+
+inline Result<void> Unmap(const Tensor& tensor, void* data) noexcept
+{
+    return rmlUnmapTensor(tensor(), data);
+}
+
+inline Result<void> SetInput(const Model& model, const char* name, const Tensor& tensor) noexcept
+{
+    return rmlSetModelInput(model(), name, tensor());
+}
+
+inline Result<void> SetInput(const Model& model, const Tensor& tensor) noexcept
+{
+    return SetInput(model, nullptr, tensor);
+}
+
+inline Result<void> SetOutput(const Model& model, const char* name, const Tensor& tensor) noexcept
+{
+    return rmlSetModelOutput(model(), name, tensor());
+}
+
+inline Result<void> SetOutput(const Model& model, const Tensor& tensor) noexcept
+{
+    return SetOutput(model, nullptr, tensor);
+}
+
+inline Result<void> Infer(const Model& model) noexcept
+{
+    return rmlInfer(model());
+}
+
+} // namespace nothrow
+
 } // namespace rml
 
 #undef RML_CHECK_STATUS
+#undef RML_COROUTINES_ENABLED
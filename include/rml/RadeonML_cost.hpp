@@ -0,0 +1,1320 @@
+/*****************************************************************************
+Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*****************************************************************************/
+#pragma once
+
+/**
+ * @file
+ * @brief Static graph cost estimation C++ API
+ */
+
+#include "rml/RadeonML.hpp"
+#include "rml/RadeonML_utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rml {
+
+/**
+ * Estimated cost of a single graph operation.
+ */
+struct OpCost
+{
+    rml_op op = nullptr;
+    rml_op_type op_type = RML_OP_UNSPECIFIED;
+    std::string op_name;
+
+    /**
+     * Whether the output shape is inferred. Costs of unresolved operations are zero.
+     */
+    bool resolved = false;
+
+    rml_dtype output_dtype = RML_DTYPE_UNSPECIFIED;
+    rml_layout output_layout = RML_LAYOUT_UNSPECIFIED;
+    std::vector<uint32_t> output_shape;
+
+    uint64_t num_flops = 0;         /**< Arithmetic operations, a multiply-add counts as two. */
+    uint64_t num_bytes_read = 0;    /**< Bytes read from all inputs, including weights. */
+    uint64_t num_bytes_written = 0; /**< Bytes written to the output. */
+};
+
+/**
+ * Estimated cost of a graph.
+ */
+struct CostEstimate
+{
+    uint64_t num_flops = 0;
+    uint64_t num_bytes_read = 0;
+    uint64_t num_bytes_written = 0;
+    size_t num_unresolved = 0; /**< Number of operations with an unknown cost. */
+    std::vector<OpCost> ops;   /**< Per-operation costs in the topological order. */
+};
+
+/**
+ * Returns the number of arithmetic operations per byte moved.
+ * Low values indicate memory-bound operations.
+ */
+inline double GetArithmeticIntensity(const OpCost& cost)
+{
+    uint64_t num_bytes = cost.num_bytes_read + cost.num_bytes_written;
+    return num_bytes != 0 ? static_cast<double>(cost.num_flops) / num_bytes : 0.0;
+}
+
+inline double GetArithmeticIntensity(const CostEstimate& estimate)
+{
+    uint64_t num_bytes = estimate.num_bytes_read + estimate.num_bytes_written;
+    return num_bytes != 0 ? static_cast<double>(estimate.num_flops) / num_bytes : 0.0;
+}
+
+namespace details {
+
+inline uint64_t GetNumElements(const std::vector<uint32_t>& shape)
+{
+    uint64_t num_elements = 1;
+    for (uint32_t dim : shape)
+    {
+        num_elements *= dim;
+    }
+    return num_elements;
+}
+
+inline size_t GetDTypeSize(rml_dtype dtype)
+{
+    switch (dtype)
+    {
+    case RML_DTYPE_FLOAT32:
+    case RML_DTYPE_INT32:
+        return 4;
+    case RML_DTYPE_FLOAT16:
+        return 2;
+    case RML_DTYPE_UINT8:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+inline uint64_t GetNumBytes(const OpCost& cost)
+{
+    // Qualified, so argument-dependent lookup does not find a global GetDTypeSize(rml_dtype)
+    return GetNumElements(cost.output_shape) * details::GetDTypeSize(cost.output_dtype);
+}
+
+/**
+ * Normalizes a possibly negative axis, returns false if it is out of range.
+ */
+inline bool NormalizeAxis(int64_t axis, size_t rank, size_t& result)
+{
+    if (axis < 0)
+    {
+        axis += static_cast<int64_t>(rank);
+    }
+    if (axis < 0 || axis >= static_cast<int64_t>(rank))
+    {
+        return false;
+    }
+    result = static_cast<size_t>(axis);
+    return true;
+}
+
+struct ImageAxes
+{
+    size_t c;
+    size_t h;
+    size_t w;
+};
+
+inline bool GetImageAxes(rml_layout layout, size_t rank, ImageAxes& axes)
+{
+    switch (layout)
+    {
+    case RML_LAYOUT_NCHW:
+        axes = {1, 2, 3};
+        break;
+    case RML_LAYOUT_NHWC:
+        axes = {3, 1, 2};
+        break;
+    case RML_LAYOUT_CHW:
+        axes = {0, 1, 2};
+        break;
+    case RML_LAYOUT_HWC:
+        axes = {2, 0, 1};
+        break;
+    default:
+        return false;
+    }
+    return rank == GetLayoutNumDims(layout);
+}
+
+struct FilterAxes
+{
+    size_t o;
+    size_t i;
+    size_t h;
+    size_t w;
+};
+
+inline bool GetFilterAxes(rml_layout layout, size_t rank, FilterAxes& axes)
+{
+    switch (layout)
+    {
+    case RML_LAYOUT_OIHW:
+        axes = {0, 1, 2, 3};
+        break;
+    case RML_LAYOUT_HWIO:
+        axes = {3, 2, 0, 1};
+        break;
+    default:
+        return false;
+    }
+    return rank == 4;
+}
+
+/**
+ * Computes an output spatial size of a convolution or pooling, see #rml_padding_type.
+ */
+inline bool GetWindowOutputSize(uint32_t input_size,
+                                uint32_t kernel_size,
+                                uint32_t stride,
+                                uint32_t dilation,
+                                uint32_t start_padding,
+                                uint32_t end_padding,
+                                rml_padding_type padding_type,
+                                bool ceil_mode,
+                                uint32_t& output_size)
+{
+    stride = std::max(stride, 1u);
+    dilation = std::max(dilation, 1u);
+    if (padding_type == RML_PADDING_SAME_LOWER || padding_type == RML_PADDING_SAME_UPPER)
+    {
+        output_size = (input_size + stride - 1) / stride;
+        return true;
+    }
+    uint64_t padded_size = input_size;
+    if (padding_type != RML_PADDING_VALID)
+    {
+        padded_size += uint64_t(start_padding) + end_padding;
+    }
+    uint64_t window_size = uint64_t(kernel_size - 1) * dilation + 1;
+    if (kernel_size == 0 || padded_size < window_size)
+    {
+        return false;
+    }
+    uint64_t num_steps = padded_size - window_size + (ceil_mode ? stride - 1 : 0);
+    output_size = static_cast<uint32_t>(num_steps / stride + 1);
+    return true;
+}
+
+/**
+ * Computes an output spatial size of a transposed convolution, see #rml_padding_type.
+ */
+inline bool GetTransposedWindowOutputSize(uint32_t input_size,
+                                          uint32_t kernel_size,
+                                          uint32_t stride,
+                                          uint32_t dilation,
+                                          uint32_t start_padding,
+                                          uint32_t end_padding,
+                                          uint32_t output_padding,
+                                          rml_padding_type padding_type,
+                                          uint32_t& output_size)
+{
+    stride = std::max(stride, 1u);
+    dilation = std::max(dilation, 1u);
+    if (padding_type == RML_PADDING_SAME_LOWER || padding_type == RML_PADDING_SAME_UPPER)
+    {
+        output_size = input_size * stride;
+        return true;
+    }
+    if (kernel_size == 0 || input_size == 0)
+    {
+        return false;
+    }
+    int64_t size = int64_t(input_size - 1) * stride + int64_t(kernel_size - 1) * dilation + 1 +
+                   output_padding;
+    if (padding_type != RML_PADDING_VALID)
+    {
+        size -= int64_t(start_padding) + end_padding;
+    }
+    if (size <= 0)
+    {
+        return false;
+    }
+    output_size = static_cast<uint32_t>(size);
+    return true;
+}
+
+/**
+ * Infers operation output shapes and estimates costs in the topological order.
+ */
+class CostEstimator
+{
+public:
+    explicit CostEstimator(const std::unordered_map<std::string, rml_tensor_info>& input_infos)
+        : m_input_infos(input_infos)
+    {
+    }
+
+    CostEstimate Run(const Graph& graph)
+    {
+        for (rml_op op : graph.GetOps())
+        {
+            rml_op_desc desc = GetOpDesc(op);
+            m_descs[op] = desc;
+
+            OpCost cost;
+            cost.op = op;
+            cost.op_type = desc.op_type;
+            cost.op_name = desc.op_name != nullptr ? desc.op_name : "";
+            if (EstimateOp(desc, cost))
+            {
+                cost.resolved = true;
+                if (desc.op_type != RML_OP_PLACEHOLDER && desc.op_type != RML_OP_CONST)
+                {
+                    cost.num_bytes_written = GetNumBytes(cost);
+                }
+                m_estimate.num_flops += cost.num_flops;
+                m_estimate.num_bytes_read += cost.num_bytes_read;
+                m_estimate.num_bytes_written += cost.num_bytes_written;
+            }
+            else
+            {
+                OpCost unresolved;
+                unresolved.op = op;
+                unresolved.op_type = desc.op_type;
+                unresolved.op_name = std::move(cost.op_name);
+                cost = std::move(unresolved);
+                m_estimate.num_unresolved++;
+            }
+
+            m_indices[op] = m_estimate.ops.size();
+            m_estimate.ops.push_back(std::move(cost));
+        }
+        return std::move(m_estimate);
+    }
+
+private:
+    /**
+     * Returns a resolved operation cost or null.
+     */
+    const OpCost* Find(rml_op op) const
+    {
+        auto iter = m_indices.find(op);
+        if (op == nullptr || iter == m_indices.end() || !m_estimate.ops[iter->second].resolved)
+        {
+            return nullptr;
+        }
+        return &m_estimate.ops[iter->second];
+    }
+
+    /**
+     * Reads values of a small int32 or float32 constant operation.
+     */
+    bool GetConstValues(rml_op op, std::vector<double>& values) const
+    {
+        const OpCost* cost = Find(op);
+        if (cost == nullptr || cost->op_type != RML_OP_CONST)
+        {
+            return false;
+        }
+        const rml_op_const_params& params = m_descs.at(op).constant;
+        size_t num_elements = static_cast<size_t>(GetNumElements(cost->output_shape));
+        if (params.tensor_data == nullptr || num_elements > RML_TENSOR_MAX_RANK * 4)
+        {
+            return false;
+        }
+        values.resize(num_elements);
+        for (size_t i = 0; i < num_elements; i++)
+        {
+            if (cost->output_dtype == RML_DTYPE_INT32)
+            {
+                int32_t value;
+                std::memcpy(&value, static_cast<const char*>(params.tensor_data) + i * 4, 4);
+                values[i] = value;
+            }
+            else if (cost->output_dtype == RML_DTYPE_FLOAT32)
+            {
+                float value;
+                std::memcpy(&value, static_cast<const char*>(params.tensor_data) + i * 4, 4);
+                values[i] = value;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void Read(const OpCost& input, OpCost& cost)
+    {
+        cost.num_bytes_read += GetNumBytes(input);
+    }
+
+    /**
+     * Counts reads of auxiliary inputs, e.g. weights, which do not affect the output shape.
+     */
+    void ReadOptional(std::initializer_list<rml_op> inputs, OpCost& cost) const
+    {
+        for (rml_op op : inputs)
+        {
+            if (const OpCost* input = Find(op))
+            {
+                Read(*input, cost);
+            }
+        }
+    }
+
+    static void SetOutput(const OpCost& input, OpCost& cost)
+    {
+        cost.output_dtype = input.output_dtype;
+        cost.output_layout = input.output_layout;
+        cost.output_shape = input.output_shape;
+    }
+
+    static bool SetInfo(const rml_tensor_info& info, OpCost& cost)
+    {
+        size_t rank = GetLayoutNumDims(info.layout);
+        if (info.layout == RML_LAYOUT_UNSPECIFIED)
+        {
+            while (rank < RML_TENSOR_MAX_RANK && info.shape[rank] != RML_DIM_UNSPECIFIED)
+            {
+                rank++;
+            }
+        }
+        cost.output_dtype = info.dtype;
+        cost.output_layout = info.layout;
+        cost.output_shape.assign(info.shape, info.shape + std::min(rank, RML_TENSOR_MAX_RANK));
+        return std::find(cost.output_shape.begin(),
+                         cost.output_shape.end(),
+                         RML_DIM_UNSPECIFIED) == cost.output_shape.end();
+    }
+
+    bool EstimateUnary(rml_op input_op, uint64_t flops_per_element, OpCost& cost) const
+    {
+        const OpCost* input = Find(input_op);
+        if (input == nullptr)
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        Read(*input, cost);
+        cost.num_flops = flops_per_element * GetNumElements(input->output_shape);
+        return true;
+    }
+
+    /**
+     * Element-wise binary operation with numpy-style broadcasting.
+     */
+    bool EstimateBinary(rml_op input1_op, rml_op input2_op, OpCost& cost) const
+    {
+        const OpCost* input1 = Find(input1_op);
+        const OpCost* input2 = Find(input2_op);
+        if (input1 == nullptr || input2 == nullptr)
+        {
+            return false;
+        }
+        const OpCost& larger =
+            input1->output_shape.size() >= input2->output_shape.size() ? *input1 : *input2;
+        const OpCost& smaller = &larger == input1 ? *input2 : *input1;
+        SetOutput(larger, cost);
+        size_t offset = larger.output_shape.size() - smaller.output_shape.size();
+        for (size_t i = 0; i < smaller.output_shape.size(); i++)
+        {
+            uint32_t& dim = cost.output_shape[offset + i];
+            uint32_t other_dim = smaller.output_shape[i];
+            if (dim != other_dim && dim != 1 && other_dim != 1)
+            {
+                return false;
+            }
+            dim = std::max(dim, other_dim);
+        }
+        Read(*input1, cost);
+        Read(*input2, cost);
+        cost.num_flops = GetNumElements(cost.output_shape);
+        return true;
+    }
+
+    bool EstimateConv2D(const rml_op_conv_2d_params& params, bool depthwise, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        const OpCost* weights = Find(params.weights);
+        ImageAxes axes;
+        FilterAxes filter_axes;
+        if (input == nullptr || weights == nullptr ||
+            !GetImageAxes(input->output_layout, input->output_shape.size(), axes) ||
+            !GetFilterAxes(weights->output_layout, weights->output_shape.size(), filter_axes))
+        {
+            return false;
+        }
+        const std::vector<uint32_t>& filter = weights->output_shape;
+        uint32_t kernel_h = filter[filter_axes.h];
+        uint32_t kernel_w = filter[filter_axes.w];
+        uint32_t num_channels = filter[filter_axes.o];
+        uint64_t num_products = uint64_t(kernel_h) * kernel_w * filter[filter_axes.i];
+        if (depthwise)
+        {
+            // A channel multiplier is stored either as O with I == 1 or as O with I == C
+            uint32_t input_channels = input->output_shape[axes.c];
+            if (filter[filter_axes.i] == input_channels && input_channels != 1)
+            {
+                num_channels *= input_channels;
+            }
+            num_products = uint64_t(kernel_h) * kernel_w;
+        }
+
+        SetOutput(*input, cost);
+        cost.output_shape[axes.c] = num_channels;
+        if (!GetWindowOutputSize(input->output_shape[axes.h],
+                                 kernel_h,
+                                 params.strides.h,
+                                 params.dilations.h,
+                                 params.start_paddings.h,
+                                 params.end_paddings.h,
+                                 params.padding_type,
+                                 false,
+                                 cost.output_shape[axes.h]) ||
+            !GetWindowOutputSize(input->output_shape[axes.w],
+                                 kernel_w,
+                                 params.strides.w,
+                                 params.dilations.w,
+                                 params.start_paddings.w,
+                                 params.end_paddings.w,
+                                 params.padding_type,
+                                 false,
+                                 cost.output_shape[axes.w]))
+        {
+            return false;
+        }
+        Read(*input, cost);
+        Read(*weights, cost);
+        cost.num_flops = 2 * GetNumElements(cost.output_shape) * num_products;
+        return true;
+    }
+
+    /**
+     * Weights are treated as the filter of the forward convolution, as in ONNX and TF:
+     * the O axis holds input channels and the I axis holds output channels per group.
+     * A non-zero output_shape overrides the spatial output size.
+     */
+    bool EstimateConv2DTranspose(const rml_op_conv_2d_transpose_params& params,
+                                 OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        const OpCost* weights = Find(params.weights);
+        ImageAxes axes;
+        FilterAxes filter_axes;
+        if (input == nullptr || weights == nullptr ||
+            !GetImageAxes(input->output_layout, input->output_shape.size(), axes) ||
+            !GetFilterAxes(weights->output_layout, weights->output_shape.size(), filter_axes))
+        {
+            return false;
+        }
+        const std::vector<uint32_t>& filter = weights->output_shape;
+        uint32_t kernel_h = filter[filter_axes.h];
+        uint32_t kernel_w = filter[filter_axes.w];
+        uint32_t num_groups = std::max(params.num_groups, 1u);
+
+        SetOutput(*input, cost);
+        cost.output_shape[axes.c] = filter[filter_axes.i] * num_groups;
+        if (params.output_shape.h != 0 && params.output_shape.w != 0)
+        {
+            cost.output_shape[axes.h] = params.output_shape.h;
+            cost.output_shape[axes.w] = params.output_shape.w;
+        }
+        else if (!GetTransposedWindowOutputSize(input->output_shape[axes.h],
+                                                kernel_h,
+                                                params.strides.h,
+                                                params.dilations.h,
+                                                params.start_paddings.h,
+                                                params.end_paddings.h,
+                                                params.output_paddings.h,
+                                                params.padding_type,
+                                                cost.output_shape[axes.h]) ||
+                 !GetTransposedWindowOutputSize(input->output_shape[axes.w],
+                                                kernel_w,
+                                                params.strides.w,
+                                                params.dilations.w,
+                                                params.start_paddings.w,
+                                                params.end_paddings.w,
+                                                params.output_paddings.w,
+                                                params.padding_type,
+                                                cost.output_shape[axes.w]))
+        {
+            return false;
+        }
+        Read(*input, cost);
+        Read(*weights, cost);
+        // Every input element is scattered to a kernel window of each output channel in its group
+        cost.num_flops = 2 * GetNumElements(input->output_shape) * filter[filter_axes.i] *
+                         kernel_h * kernel_w;
+        return true;
+    }
+
+    bool EstimatePool2D(const rml_op_pool_2d_params& params, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        ImageAxes axes;
+        if (input == nullptr ||
+            !GetImageAxes(input->output_layout, input->output_shape.size(), axes))
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        if (!GetWindowOutputSize(input->output_shape[axes.h],
+                                 params.kernel_size.h,
+                                 params.strides.h,
+                                 params.dilations.h,
+                                 params.start_paddings.h,
+                                 params.end_paddings.h,
+                                 params.padding_type,
+                                 params.ceil_mode != RML_FALSE,
+                                 cost.output_shape[axes.h]) ||
+            !GetWindowOutputSize(input->output_shape[axes.w],
+                                 params.kernel_size.w,
+                                 params.strides.w,
+                                 params.dilations.w,
+                                 params.start_paddings.w,
+                                 params.end_paddings.w,
+                                 params.padding_type,
+                                 params.ceil_mode != RML_FALSE,
+                                 cost.output_shape[axes.w]))
+        {
+            return false;
+        }
+        Read(*input, cost);
+        cost.num_flops = GetNumElements(cost.output_shape) * params.kernel_size.h *
+                         params.kernel_size.w;
+        return true;
+    }
+
+    bool EstimateGlobalPool2D(rml_op input_op, OpCost& cost) const
+    {
+        const OpCost* input = Find(input_op);
+        ImageAxes axes;
+        if (input == nullptr ||
+            !GetImageAxes(input->output_layout, input->output_shape.size(), axes))
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        cost.output_shape[axes.h] = 1;
+        cost.output_shape[axes.w] = 1;
+        Read(*input, cost);
+        cost.num_flops = GetNumElements(input->output_shape);
+        return true;
+    }
+
+    bool EstimateGemm(const rml_op_gemm_params& params, OpCost& cost) const
+    {
+        const OpCost* input_a = Find(params.input_a);
+        const OpCost* input_b = Find(params.input_b);
+        const OpCost* input_c = Find(params.input_c);
+        if (input_a == nullptr || input_b == nullptr || input_a->output_shape.size() != 2 ||
+            input_b->output_shape.size() != 2 || (params.input_c != nullptr && input_c == nullptr))
+        {
+            return false;
+        }
+        bool transpose_a = params.transpose_a != RML_FALSE;
+        bool transpose_b = params.transpose_b != RML_FALSE;
+        uint64_t m = input_a->output_shape[transpose_a ? 1 : 0];
+        uint64_t k = input_a->output_shape[transpose_a ? 0 : 1];
+        uint64_t n = input_b->output_shape[transpose_b ? 0 : 1];
+        if (input_b->output_shape[transpose_b ? 1 : 0] != k)
+        {
+            return false;
+        }
+        cost.output_dtype = input_a->output_dtype;
+        cost.output_layout = RML_LAYOUT_NC;
+        cost.output_shape = {static_cast<uint32_t>(m), static_cast<uint32_t>(n)};
+        Read(*input_a, cost);
+        Read(*input_b, cost);
+        cost.num_flops = 2 * m * n * k;
+        if (input_c != nullptr)
+        {
+            Read(*input_c, cost);
+            cost.num_flops += 2 * m * n;
+        }
+        return true;
+    }
+
+    bool EstimateDepthToSpace(rml_op input_op, uint32_t block_size, bool to_space, OpCost& cost)
+        const
+    {
+        const OpCost* input = Find(input_op);
+        ImageAxes axes;
+        if (input == nullptr || block_size == 0 ||
+            !GetImageAxes(input->output_layout, input->output_shape.size(), axes))
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        std::vector<uint32_t>& shape = cost.output_shape;
+        uint32_t block_area = block_size * block_size;
+        if (to_space)
+        {
+            if (shape[axes.c] % block_area != 0)
+            {
+                return false;
+            }
+            shape[axes.c] /= block_area;
+            shape[axes.h] *= block_size;
+            shape[axes.w] *= block_size;
+        }
+        else
+        {
+            if (shape[axes.h] % block_size != 0 || shape[axes.w] % block_size != 0)
+            {
+                return false;
+            }
+            shape[axes.c] *= block_area;
+            shape[axes.h] /= block_size;
+            shape[axes.w] /= block_size;
+        }
+        Read(*input, cost);
+        return true;
+    }
+
+    bool EstimateReduce(const rml_op_reduce_params& params, rml_op_type op_type, OpCost& cost)
+        const
+    {
+        const OpCost* input = Find(params.input);
+        if (input == nullptr)
+        {
+            return false;
+        }
+        size_t rank = input->output_shape.size();
+        std::vector<bool> reduced(rank, params.num_axes == 0);
+        for (size_t i = 0; i < params.num_axes && i < RML_TENSOR_MAX_RANK; i++)
+        {
+            size_t axis;
+            if (!NormalizeAxis(params.axes[i], rank, axis))
+            {
+                return false;
+            }
+            reduced[axis] = true;
+        }
+        SetOutput(*input, cost);
+        cost.output_shape.clear();
+        for (size_t i = 0; i < rank; i++)
+        {
+            if (!reduced[i] || params.keep_dims != RML_FALSE)
+            {
+                cost.output_shape.push_back(reduced[i] ? 1 : input->output_shape[i]);
+            }
+        }
+        if (params.keep_dims == RML_FALSE)
+        {
+            cost.output_layout = RML_LAYOUT_UNSPECIFIED;
+        }
+        if (op_type == RML_OP_REDUCE_ARGMAX || op_type == RML_OP_REDUCE_ARGMIN)
+        {
+            cost.output_dtype = RML_DTYPE_INT32;
+        }
+        Read(*input, cost);
+        cost.num_flops = GetNumElements(input->output_shape);
+        return true;
+    }
+
+    bool EstimateTranspose(const rml_op_transpose_params& params, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        if (input == nullptr)
+        {
+            return false;
+        }
+        size_t rank = input->output_shape.size();
+        if (params.num_axes != 0 && params.num_axes != rank)
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        std::vector<size_t> perm(rank);
+        for (size_t i = 0; i < rank; i++)
+        {
+            if (params.num_axes == 0)
+            {
+                perm[i] = rank - 1 - i;
+            }
+            else if (!NormalizeAxis(params.axes[i], rank, perm[i]))
+            {
+                return false;
+            }
+            cost.output_shape[i] = input->output_shape[perm[i]];
+        }
+        const std::vector<size_t> kToNHWC = {0, 2, 3, 1};
+        const std::vector<size_t> kToNCHW = {0, 3, 1, 2};
+        if (input->output_layout == RML_LAYOUT_NCHW && perm == kToNHWC)
+        {
+            cost.output_layout = RML_LAYOUT_NHWC;
+        }
+        else if (input->output_layout == RML_LAYOUT_NHWC && perm == kToNCHW)
+        {
+            cost.output_layout = RML_LAYOUT_NCHW;
+        }
+        else
+        {
+            cost.output_layout = RML_LAYOUT_UNSPECIFIED;
+        }
+        Read(*input, cost);
+        return true;
+    }
+
+    bool EstimatePad(const rml_op_pad_params& params, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        if (input == nullptr || params.num_dims > input->output_shape.size())
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        for (size_t i = 0; i < params.num_dims; i++)
+        {
+            cost.output_shape[i] += params.start_padding[i] + params.end_padding[i];
+        }
+        Read(*input, cost);
+        return true;
+    }
+
+    bool EstimateConcat(const rml_op_concat_params& params, OpCost& cost) const
+    {
+        std::vector<double> axis_value;
+        const OpCost* first = params.num_inputs > 0 ? Find(params.inputs[0]) : nullptr;
+        size_t axis;
+        if (first == nullptr || !GetConstValues(params.axis, axis_value) ||
+            axis_value.size() != 1 ||
+            !NormalizeAxis(static_cast<int64_t>(axis_value[0]), first->output_shape.size(), axis))
+        {
+            return false;
+        }
+        SetOutput(*first, cost);
+        cost.output_shape[axis] = 0;
+        for (size_t i = 0; i < params.num_inputs; i++)
+        {
+            const OpCost* input = Find(params.inputs[i]);
+            if (input == nullptr || input->output_shape.size() != first->output_shape.size())
+            {
+                return false;
+            }
+            cost.output_shape[axis] += input->output_shape[axis];
+            Read(*input, cost);
+        }
+        return true;
+    }
+
+    bool EstimateStack(const rml_op_stack_params& params, OpCost& cost) const
+    {
+        const OpCost* first = params.num_inputs > 0 ? Find(params.inputs[0]) : nullptr;
+        size_t axis;
+        if (first == nullptr || !NormalizeAxis(params.axis, first->output_shape.size() + 1, axis))
+        {
+            return false;
+        }
+        SetOutput(*first, cost);
+        cost.output_layout = RML_LAYOUT_UNSPECIFIED;
+        cost.output_shape.insert(cost.output_shape.begin() + axis,
+                                 static_cast<uint32_t>(params.num_inputs));
+        for (size_t i = 0; i < params.num_inputs; i++)
+        {
+            const OpCost* input = Find(params.inputs[i]);
+            if (input == nullptr || input->output_shape != first->output_shape)
+            {
+                return false;
+            }
+            Read(*input, cost);
+        }
+        return true;
+    }
+
+    bool EstimateFlatten(rml_op input_op, OpCost& cost) const
+    {
+        const OpCost* input = Find(input_op);
+        if (input == nullptr || input->output_shape.empty())
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        uint64_t num_elements = GetNumElements(input->output_shape);
+        cost.output_layout = RML_LAYOUT_NC;
+        cost.output_shape = {input->output_shape[0],
+                             static_cast<uint32_t>(num_elements / input->output_shape[0])};
+        Read(*input, cost);
+        return true;
+    }
+
+    bool EstimateSqueeze(const rml_op_squeeze_params& params, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        if (input == nullptr)
+        {
+            return false;
+        }
+        size_t rank = input->output_shape.size();
+        std::vector<bool> squeezed(rank, false);
+        for (size_t i = 0; i < rank; i++)
+        {
+            squeezed[i] = params.num_axes == 0 && input->output_shape[i] == 1;
+        }
+        for (size_t i = 0; i < params.num_axes && i < RML_TENSOR_MAX_RANK; i++)
+        {
+            size_t axis;
+            if (!NormalizeAxis(params.axes[i], rank, axis) || input->output_shape[axis] != 1)
+            {
+                return false;
+            }
+            squeezed[axis] = true;
+        }
+        SetOutput(*input, cost);
+        cost.output_layout = RML_LAYOUT_UNSPECIFIED;
+        cost.output_shape.clear();
+        for (size_t i = 0; i < rank; i++)
+        {
+            if (!squeezed[i])
+            {
+                cost.output_shape.push_back(input->output_shape[i]);
+            }
+        }
+        Read(*input, cost);
+        return true;
+    }
+
+    bool EstimateUnsqueeze(const rml_op_unsqueeze_params& params, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        if (input == nullptr)
+        {
+            return false;
+        }
+        size_t rank = input->output_shape.size() + params.num_axes;
+        std::vector<bool> inserted(rank, false);
+        for (size_t i = 0; i < params.num_axes && i < RML_TENSOR_MAX_RANK; i++)
+        {
+            size_t axis;
+            if (!NormalizeAxis(params.axes[i], rank, axis))
+            {
+                return false;
+            }
+            inserted[axis] = true;
+        }
+        SetOutput(*input, cost);
+        cost.output_layout = RML_LAYOUT_UNSPECIFIED;
+        cost.output_shape.clear();
+        for (size_t i = 0, j = 0; i < rank; i++)
+        {
+            cost.output_shape.push_back(inserted[i] ? 1 : input->output_shape[j++]);
+        }
+        Read(*input, cost);
+        return true;
+    }
+
+    /**
+     * Reshape with ONNX semantics: 0 copies an input dimension, -1 is inferred.
+     */
+    bool EstimateReshape(const rml_op_reshape_params& params, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        std::vector<double> shape;
+        if (input == nullptr || !GetConstValues(params.shape, shape))
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        cost.output_layout = RML_LAYOUT_UNSPECIFIED;
+        cost.output_shape.assign(shape.size(), 1);
+        uint64_t num_elements = GetNumElements(input->output_shape);
+        uint64_t known_elements = 1;
+        size_t inferred_axis = shape.size();
+        for (size_t i = 0; i < shape.size(); i++)
+        {
+            int64_t dim = static_cast<int64_t>(shape[i]);
+            if (dim == 0 && i < input->output_shape.size())
+            {
+                dim = input->output_shape[i];
+            }
+            if (dim == -1 && inferred_axis == shape.size())
+            {
+                inferred_axis = i;
+                continue;
+            }
+            if (dim <= 0)
+            {
+                return false;
+            }
+            cost.output_shape[i] = static_cast<uint32_t>(dim);
+            known_elements *= static_cast<uint64_t>(dim);
+        }
+        if (inferred_axis != shape.size() && known_elements != 0)
+        {
+            cost.output_shape[inferred_axis] = static_cast<uint32_t>(num_elements / known_elements);
+        }
+        if (GetNumElements(cost.output_shape) != num_elements)
+        {
+            return false;
+        }
+        Read(*input, cost);
+        return true;
+    }
+
+    /**
+     * Slice with numpy semantics, indices are clamped to the dimension bounds.
+     */
+    bool EstimateSlice(const rml_op_slice_params& params, OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        std::vector<double> starts;
+        std::vector<double> ends;
+        std::vector<double> axes;
+        std::vector<double> steps;
+        if (input == nullptr || !GetConstValues(params.starts, starts) ||
+            !GetConstValues(params.ends, ends) || starts.size() != ends.size() ||
+            (params.axes != nullptr && !GetConstValues(params.axes, axes)) ||
+            (params.strides != nullptr && !GetConstValues(params.strides, steps)))
+        {
+            return false;
+        }
+        if (params.axes == nullptr)
+        {
+            for (size_t i = 0; i < starts.size(); i++)
+            {
+                axes.push_back(static_cast<double>(i));
+            }
+        }
+        if (params.strides == nullptr)
+        {
+            steps.assign(starts.size(), 1.0);
+        }
+        if (axes.size() != starts.size() || steps.size() != starts.size())
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        for (size_t i = 0; i < starts.size(); i++)
+        {
+            size_t axis;
+            int64_t step = static_cast<int64_t>(steps[i]);
+            if (!NormalizeAxis(static_cast<int64_t>(axes[i]), cost.output_shape.size(), axis) ||
+                step == 0)
+            {
+                return false;
+            }
+            int64_t dim = input->output_shape[axis];
+            int64_t start = static_cast<int64_t>(starts[i]);
+            int64_t end = static_cast<int64_t>(ends[i]);
+            start = start < 0 ? start + dim : start;
+            end = end < 0 ? end + dim : end;
+            if (step > 0)
+            {
+                start = std::min(std::max(start, int64_t(0)), dim);
+                end = std::min(std::max(end, int64_t(0)), dim);
+            }
+            else
+            {
+                start = std::min(std::max(start, int64_t(-1)), dim - 1);
+                end = std::min(std::max(end, int64_t(-1)), dim - 1);
+            }
+            int64_t size = step > 0 ? (end - start + step - 1) / step
+                                    : (start - end - step - 1) / -step;
+            cost.output_shape[axis] = static_cast<uint32_t>(std::max(size, int64_t(0)));
+        }
+        Read(*input, cost);
+        return true;
+    }
+
+    /**
+     * Resize to a constant size or by constant scales, given either for the spatial axes
+     * or for all axes.
+     */
+    bool EstimateResize2D(const rml_op_resize_2d_params& params,
+                          uint64_t flops_per_element,
+                          OpCost& cost) const
+    {
+        const OpCost* input = Find(params.input);
+        ImageAxes axes;
+        std::vector<double> values;
+        bool is_size = GetConstValues(params.size, values);
+        if (input == nullptr || (!is_size && !GetConstValues(params.scales, values)) ||
+            !GetImageAxes(input->output_layout, input->output_shape.size(), axes))
+        {
+            return false;
+        }
+        SetOutput(*input, cost);
+        std::vector<size_t> resized_axes = {axes.h, axes.w};
+        if (values.size() == input->output_shape.size())
+        {
+            resized_axes.clear();
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                resized_axes.push_back(i);
+            }
+        }
+        else if (values.size() != 2)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            double dim = is_size ? values[i] : values[i] * input->output_shape[resized_axes[i]];
+            if (dim < 1.0)
+            {
+                return false;
+            }
+            cost.output_shape[resized_axes[i]] = static_cast<uint32_t>(dim);
+        }
+        Read(*input, cost);
+        cost.num_flops = flops_per_element * GetNumElements(cost.output_shape);
+        return true;
+    }
+
+    bool EstimateOp(const rml_op_desc& desc, OpCost& cost) const
+    {
+        switch (desc.op_type)
+        {
+        case RML_OP_PLACEHOLDER: {
+            auto iter = m_input_infos.find(cost.op_name);
+            return SetInfo(iter != m_input_infos.end() ? iter->second
+                                                       : desc.placeholder.tensor_info,
+                           cost);
+        }
+
+        case RML_OP_CONST:
+            return SetInfo(desc.constant.tensor_info, cost);
+
+        case RML_OP_IDENTITY:
+            return EstimateUnary(desc.unary.input, 0, cost);
+
+        case RML_OP_ABS:
+        case RML_OP_ACOS:
+        case RML_OP_ASIN:
+        case RML_OP_ATAN:
+        case RML_OP_CEIL:
+        case RML_OP_CELU:
+        case RML_OP_CLIP:
+        case RML_OP_COS:
+        case RML_OP_ELU:
+        case RML_OP_EXP:
+        case RML_OP_FLOOR:
+        case RML_OP_LEAKY_RELU:
+        case RML_OP_LOGN:
+        case RML_OP_NEG:
+        case RML_OP_RECIP:
+        case RML_OP_RELU:
+        case RML_OP_RELU6:
+        case RML_OP_RSQRT:
+        case RML_OP_SELU:
+        case RML_OP_SIGMOID:
+        case RML_OP_SIN:
+        case RML_OP_SOFTPLUS:
+        case RML_OP_SOFTSIGN:
+        case RML_OP_SQRT:
+        case RML_OP_TAN:
+        case RML_OP_TANH:
+        case RML_OP_THRESHOLDED_RELU:
+            // All the parameter structures start with the input operation
+            return EstimateUnary(desc.unary.input, 1, cost);
+
+        case RML_OP_SOFTMAX:
+        case RML_OP_LOG_SOFTMAX:
+            return EstimateUnary(desc.unary.input, 3, cost);
+
+        case RML_OP_CAST:
+            if (!EstimateUnary(desc.cast.input, 1, cost))
+            {
+                return false;
+            }
+            cost.output_dtype = desc.cast.cast_to;
+            return true;
+
+        case RML_OP_LOCAL_RESPONSE_NORM:
+            return EstimateUnary(
+                desc.local_response_norm.input, 2 * desc.local_response_norm.size, cost);
+
+        case RML_OP_QUANTIZE_LINEAR:
+            if (!EstimateUnary(desc.quantize_linear.input, 2, cost))
+            {
+                return false;
+            }
+            cost.output_dtype = RML_DTYPE_UINT8;
+            ReadOptional({desc.quantize_linear.scale, desc.quantize_linear.zero_point}, cost);
+            return true;
+
+        case RML_OP_ADD:
+        case RML_OP_AVG:
+        case RML_OP_DIV:
+        case RML_OP_MAX:
+        case RML_OP_MIN:
+        case RML_OP_MUL:
+        case RML_OP_PARAMETRIC_RELU:
+        case RML_OP_SUB:
+            return EstimateBinary(desc.binary.input1, desc.binary.input2, cost);
+
+        case RML_OP_POW:
+            return EstimateBinary(desc.pow.input, desc.pow.pow, cost);
+
+        case RML_OP_BIAS_ADD:
+            // The bias is added along the channel axis
+            if (!EstimateUnary(desc.bias_add.input, 1, cost))
+            {
+                return false;
+            }
+            ReadOptional({desc.bias_add.bias}, cost);
+            return true;
+
+        case RML_OP_BATCH_NORM:
+            if (!EstimateUnary(desc.batch_norm.input, 2, cost))
+            {
+                return false;
+            }
+            ReadOptional({desc.batch_norm.mean,
+                          desc.batch_norm.variance,
+                          desc.batch_norm.scale,
+                          desc.batch_norm.bias},
+                         cost);
+            return true;
+
+        case RML_OP_CONV_2D:
+            return EstimateConv2D(desc.conv_2d, false, cost);
+
+        case RML_OP_CONV_2D_DEPTHWISE:
+            return EstimateConv2D(desc.conv_2d_depthwise, true, cost);
+
+        case RML_OP_CONV_2D_TRANSPOSE:
+            return EstimateConv2DTranspose(desc.conv_2d_transpose, cost);
+
+        case RML_OP_POOL_2D_AVG:
+        case RML_OP_POOL_2D_MAX:
+            return EstimatePool2D(desc.pool_2d, cost);
+
+        case RML_OP_POOL_2D_GLOBAL_AVG:
+            return EstimateGlobalPool2D(desc.pool_2d_global.input, cost);
+
+        case RML_OP_GEMM:
+            return EstimateGemm(desc.gemm, cost);
+
+        case RML_OP_DEPTH_TO_SPACE:
+            return EstimateDepthToSpace(
+                desc.depth_to_space.input, desc.depth_to_space.block_size, true, cost);
+
+        case RML_OP_SPACE_TO_DEPTH:
+            return EstimateDepthToSpace(
+                desc.space_to_depth.input, desc.space_to_depth.block_size, false, cost);
+
+        case RML_OP_REDUCE_ADD:
+        case RML_OP_REDUCE_ADD_SQUARE:
+        case RML_OP_REDUCE_ARGMAX:
+        case RML_OP_REDUCE_ARGMIN:
+        case RML_OP_REDUCE_AVG:
+        case RML_OP_REDUCE_L1:
+        case RML_OP_REDUCE_L2:
+        case RML_OP_REDUCE_LOGN_ADD:
+        case RML_OP_REDUCE_LOGN_ADD_EXP:
+        case RML_OP_REDUCE_MAX:
+        case RML_OP_REDUCE_MIN:
+        case RML_OP_REDUCE_MUL:
+            return EstimateReduce(desc.reduce, desc.op_type, cost);
+
+        case RML_OP_TRANSPOSE:
+            return EstimateTranspose(desc.transpose, cost);
+
+        case RML_OP_PAD:
+            return EstimatePad(desc.pad, cost);
+
+        case RML_OP_CONCAT:
+            return EstimateConcat(desc.concat, cost);
+
+        case RML_OP_STACK:
+            return EstimateStack(desc.stack, cost);
+
+        case RML_OP_FLATTEN:
+            return EstimateFlatten(desc.flatten.input, cost);
+
+        case RML_OP_SQUEEZE:
+            return EstimateSqueeze(desc.squeeze, cost);
+
+        case RML_OP_UNSQUEEZE:
+            return EstimateUnsqueeze(desc.unsqueeze, cost);
+
+        case RML_OP_RESHAPE:
+            return EstimateReshape(desc.reshape, cost);
+
+        case RML_OP_SLICE:
+            return EstimateSlice(desc.slice, cost);
+
+        case RML_OP_RESIZE_2D_NEAREST:
+            return EstimateResize2D(desc.resize_2d, 0, cost);
+
+        case RML_OP_RESIZE_2D_BICUBIC:
+            // 16 multiply-adds per output element
+            return EstimateResize2D(desc.resize_2d, 32, cost);
+
+        case RML_OP_SHAPE: {
+            const OpCost* input = Find(desc.shape.input);
+            if (input == nullptr)
+            {
+                return false;
+            }
+            cost.output_dtype = RML_DTYPE_INT32;
+            cost.output_layout = RML_LAYOUT_C;
+            cost.output_shape = {static_cast<uint32_t>(input->output_shape.size())};
+            return true;
+        }
+
+        default:
+            // Transposed convolutions, multi-output and unknown operations
+            return false;
+        }
+    }
+
+    const std::unordered_map<std::string, rml_tensor_info>& m_input_infos;
+    std::unordered_map<rml_op, rml_op_desc> m_descs;
+    std::unordered_map<rml_op, size_t> m_indices;
+    CostEstimate m_estimate;
+};
+
+} // namespace details
+
+/**
+ * Estimates the cost of running a graph without executing anything on a device.
+ *
+ * Output shapes of operations are inferred from the operation parameters and the input
+ * shapes. Data movement operations (e.g. transpose, pad, concat) are counted as a read
+ * of all inputs and a write of the output. Constant operations cost nothing themselves,
+ * their data is counted when it is read by other operations. Operations whose output shape
+ * cannot be inferred, together with all operations depending on them, are marked as
+ * unresolved and have zero costs.
+ *
+ * @param graph       A graph to estimate.
+ * @param input_infos Optional input information by placeholder name, overriding the
+ *                    placeholder tensor info, e.g. to resolve unspecified dimensions or
+ *                    to estimate another resolution, see Model::GetInputInfo().
+ */
+inline CostEstimate EstimateCost(
+    const Graph& graph,
+    const std::unordered_map<std::string, rml_tensor_info>& input_infos = {})
+{
+    return details::CostEstimator(input_infos).Run(graph);
+}
+
+} // namespace rml
@@ -37,6 +37,16 @@ extern "C" {
  */
 typedef struct _rml_op* rml_op;
 
+/**
+ * @brief A storage for multiple graph operations.
+ */
+typedef struct _rml_ops
+{
+    size_t num_items;
+    const rml_op* items;
+
+} rml_ops;
+
 /**
  * @brief Operations supported by RadeonML.
  */
@@ -2393,6 +2403,38 @@ RML_API_ENTRY rml_status rmlCreateOperation(rml_graph graph,
                                             const rml_op_desc* op_desc,
                                             rml_op* op);
 
+/**
+ * Returns all operations in the graph in the topological order.
+ *
+ * @param[in]  graph A valid graph handle.
+ * @param[out] ops   A pointer to a structure with resulting operations.
+ *
+ * @return Graph operations in case of success and status:
+ * - #RML_OK if the operation is successful,
+ * - #RML_ERROR_BAD_PARAMETER if @p graph is invalid or @p ops is NULL.
+ *
+ * The returned operations memory is owned by the graph and must not be freed.
+ * The memory may be invalidated on the next call involving the graph.
+ * To get more details in case of failure, call rmlGetLastError().
+ */
+RML_API_ENTRY rml_status rmlGetGraphOperations(rml_graph graph, rml_ops* ops);
+
+/**
+ * Returns an operation description.
+ *
+ * @param[in]  op      A valid operation handle.
+ * @param[out] op_desc A pointer to a resulting operation description structure.
+ *
+ * @return Operation description in case of success and status:
+ * - #RML_OK if the operation is successful,
+ * - #RML_ERROR_BAD_PARAMETER if @p op is invalid or @p op_desc is NULL.
+ *
+ * The operation name and any arrays referenced by the description are owned by the graph
+ * and remain valid until the graph is released.
+ * To get more details in case of failure, call rmlGetLastError().
+ */
+RML_API_ENTRY rml_status rmlGetOperationDesc(rml_op op, rml_op_desc* op_desc);
+
 /**
  * Releases a graph created with rmlCreateGraph() or rmlLoadgraph(), invalidates the handle.
  *
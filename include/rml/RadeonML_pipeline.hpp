@@ -0,0 +1,277 @@
+/*****************************************************************************
+Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*****************************************************************************/
+#pragma once
+
+/**
+ * @file
+ * @brief Upload/inference/download pipeline C++ API
+ */
+
+#include "rml/RadeonML.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rml {
+
+/**
+ * Accumulated pipeline stage times.
+ */
+struct PipelineStats
+{
+    size_t num_frames = 0;
+    double upload_ms = 0.0;   /**< Total time spent in upload callbacks. */
+    double infer_ms = 0.0;    /**< Total time spent in inference. */
+    double download_ms = 0.0; /**< Total time spent in download callbacks. */
+    double total_ms = 0.0;    /**< Wall time of the whole run. */
+};
+
+/**
+ * Runs uploads, inference and downloads of consecutive frames concurrently.
+ *
+ * The pipeline owns N sets of model input and output tensors and rotates them, so frame
+ * i + 1 is uploaded while frame i is inferred and frame i - 1 is downloaded. Each stage runs
+ * on its own thread, inference of frames is serialized in the frame order.
+ * With N = 1 stages of all frames are executed one after another.
+ *
+ * The model inputs and outputs are rebound by name only when the inferred tensor set
+ * changes, i.e. once per run with N = 1 and on every frame otherwise.
+ */
+class Pipeline
+{
+public:
+    /**
+     * Upload callback: fills the input tensors of a frame, in the input names order.
+     */
+    using UploadFunc = std::function<void(size_t frame, const std::vector<Tensor>& inputs)>;
+
+    /**
+     * Download callback: consumes the output tensors of a frame, in the output names order.
+     */
+    using DownloadFunc = std::function<void(size_t frame, const std::vector<Tensor>& outputs)>;
+
+    /**
+     * Creates the tensor sets. All model input dimensions must be specified.
+     *
+     * @param context      A context the model is created in.
+     * @param model        A model, must outlive the pipeline.
+     * @param input_names  Names of the model inputs to feed.
+     * @param output_names Names of the model outputs to fetch.
+     * @param depth        A number of tensor sets, i.e. frames in flight.
+     */
+    Pipeline(const Context& context,
+             const Model& model,
+             const std::vector<std::string>& input_names,
+             const std::vector<std::string>& output_names,
+             size_t depth = 3)
+        : m_model(model), m_input_names(input_names), m_output_names(output_names),
+          m_inputs(std::max<size_t>(depth, 1)), m_outputs(std::max<size_t>(depth, 1))
+    {
+        for (auto& inputs : m_inputs)
+        {
+            for (const auto& name : m_input_names)
+            {
+                inputs.push_back(
+                    context.CreateTensor(m_model.GetInputInfo(name), RML_ACCESS_MODE_WRITE_ONLY));
+            }
+        }
+        for (auto& outputs : m_outputs)
+        {
+            for (const auto& name : m_output_names)
+            {
+                outputs.push_back(
+                    context.CreateTensor(m_model.GetOutputInfo(name), RML_ACCESS_MODE_READ_ONLY));
+            }
+        }
+    }
+
+    size_t GetDepth() const { return m_inputs.size(); }
+
+    /**
+     * Processes frames [0, num_frames) and returns the stage times.
+     * The first exception thrown by any stage stops the pipeline and is rethrown.
+     * If exceptions are disabled, errors abort the process instead.
+     */
+    PipelineStats Run(size_t num_frames, const UploadFunc& upload, const DownloadFunc& download)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        State state;
+        PipelineStats stats;
+        stats.num_frames = num_frames;
+        const size_t depth = GetDepth();
+        m_bound_slot = kNoSlot;
+
+        auto run_stage = [&](size_t State::*done,
+                             size_t State::*ready,
+                             size_t lag,
+                             double PipelineStats::*time,
+                             const std::function<void(size_t, size_t)>& func) {
+            for (size_t frame = 0; frame < num_frames; frame++)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(state.mutex);
+                    state.cv.wait(lock, [&] {
+                        return state.error || frame < state.*ready + lag;
+                    });
+                    if (state.error)
+                    {
+                        return;
+                    }
+                }
+                bool succeeded = Invoke(state, [&] {
+                    auto start = Clock::now();
+                    func(frame, frame % depth);
+                    stats.*time +=
+                        std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                });
+                if (!succeeded)
+                {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.*done = frame + 1;
+                state.cv.notify_all();
+            }
+        };
+
+        auto start = Clock::now();
+
+        // A frame may be uploaded once the tensor set is released by the download stage
+        std::thread upload_thread(
+            run_stage,
+            &State::uploaded,
+            &State::downloaded,
+            depth,
+            &PipelineStats::upload_ms,
+            [&](size_t frame, size_t slot) { upload(frame, m_inputs[slot]); });
+
+        std::thread download_thread(
+            run_stage,
+            &State::downloaded,
+            &State::inferred,
+            0,
+            &PipelineStats::download_ms,
+            [&](size_t frame, size_t slot) { download(frame, m_outputs[slot]); });
+
+        // Inference runs on the calling thread
+        run_stage(&State::inferred,
+                  &State::uploaded,
+                  0,
+                  &PipelineStats::infer_ms,
+                  [&](size_t, size_t slot) { Infer(slot); });
+
+        upload_thread.join();
+        download_thread.join();
+        stats.total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+#if RML_EXCEPTIONS_ENABLED
+        if (state.error)
+        {
+            std::rethrow_exception(state.error);
+        }
+#endif
+        return stats;
+    }
+
+private:
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::exception_ptr error;
+        size_t uploaded = 0;
+        size_t inferred = 0;
+        size_t downloaded = 0;
+    };
+
+    static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+
+    /**
+     * Calls a stage function, capturing its exception into the state and waking
+     * other stages. Returns false if the function has thrown.
+     */
+    template<class F>
+    static bool Invoke(State& state, const F& func)
+    {
+#if RML_EXCEPTIONS_ENABLED
+        try
+        {
+            func();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (!state.error)
+            {
+                state.error = std::current_exception();
+            }
+            state.cv.notify_all();
+            return false;
+        }
+#else
+        (void) state;
+        func();
+#endif
+        return true;
+    }
+
+    void Infer(size_t slot)
+    {
+        if (slot != m_bound_slot)
+        {
+            Bind(slot);
+        }
+        m_model.Infer();
+    }
+
+    void Bind(size_t slot)
+    {
+        m_bound_slot = kNoSlot;
+        for (size_t i = 0; i < m_input_names.size(); i++)
+        {
+            m_model.SetInput(m_input_names[i], m_inputs[slot][i]);
+        }
+        for (size_t i = 0; i < m_output_names.size(); i++)
+        {
+            m_model.SetOutput(m_output_names[i], m_outputs[slot][i]);
+        }
+        m_bound_slot = slot;
+    }
+
+    const Model& m_model;
+    std::vector<std::string> m_input_names;
+    std::vector<std::string> m_output_names;
+    std::vector<std::vector<Tensor>> m_inputs;
+    std::vector<std::vector<Tensor>> m_outputs;
+    size_t m_bound_slot = kNoSlot;
+};
+
+} // namespace rml
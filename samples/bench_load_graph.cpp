@@ -0,0 +1,122 @@
+/*****************************************************************************
+Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*****************************************************************************/
+#include "rml/RadeonML.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Get file size
+ *
+ * @param path - name of file
+ * @return - file size in bytes
+ */
+size_t GetFileSize(const std::string& path)
+{
+    std::ifstream file(path, std::ios_base::binary | std::ios_base::ate);
+    if (file.fail())
+    {
+        throw std::runtime_error(std::string("Error reading ") + path);
+    }
+    return static_cast<size_t>(file.tellg());
+}
+
+/*
+ * Collect type and name of every graph operation
+ *
+ * @param graph - loaded graph
+ * @return - list of operation signatures in the graph order
+ */
+std::vector<std::string> GetOpSignatures(const rml::Graph& graph)
+{
+    std::vector<std::string> signatures;
+    for (rml_op op : graph.GetOps())
+    {
+        rml_op_desc desc = rml::GetOpDesc(op);
+        signatures.push_back(std::to_string(desc.op_type) + ":" +
+                             (desc.op_name != nullptr ? desc.op_name : ""));
+    }
+    return signatures;
+}
+
+/*
+ * This benchmark measures how long it takes to load a graph from a file.
+ * As a sanity check, operation types and names of every loaded graph are compared
+ * with the first load; weights and attributes are not compared.
+ *
+ * Usage: bench_load_graph [model] [num_iterations]
+ */
+int main(int argc, char* argv[]) try
+{
+    // Set model path
+    const std::string model_path = argc > 1 ? argv[1] : "models/esrgan-03x2x32-273866.pb";
+
+    // Set number of measured loads
+    const int num_iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 10;
+
+    const size_t file_size = GetFileSize(model_path);
+    std::cout << "Model: " << model_path << " (" << file_size << " bytes)\n";
+
+    // Warm up the file system cache and take the reference graph
+    std::vector<std::string> reference_ops;
+    {
+        rml::Graph graph = rml::LoadGraphFromFile(
+            std::basic_string<rml_char>(model_path.begin(), model_path.end()));
+        reference_ops = GetOpSignatures(graph);
+    }
+    std::cout << "Operations: " << reference_ops.size() << "\n";
+
+    // Measure loads
+    std::vector<double> times_ms;
+    for (int i = 0; i < num_iterations; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        rml::Graph graph = rml::LoadGraphFromFile(
+            std::basic_string<rml_char>(model_path.begin(), model_path.end()));
+        auto end = std::chrono::steady_clock::now();
+        times_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+        // Check the loaded operations
+        if (GetOpSignatures(graph) != reference_ops)
+        {
+            throw std::runtime_error("Loaded operations differ from the first load");
+        }
+    }
+
+    std::sort(times_ms.begin(), times_ms.end());
+    const double median_ms = times_ms[times_ms.size() / 2];
+    std::cout << "Iterations: " << times_ms.size() << "\n";
+    std::cout << "Load time, ms: min " << times_ms.front() << ", median " << median_ms << ", max "
+              << times_ms.back() << "\n";
+    std::cout << "Load throughput, MB/s: " << file_size / (median_ms * 1e3) << std::endl;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
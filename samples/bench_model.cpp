@@ -0,0 +1,273 @@
+/*****************************************************************************
+Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*****************************************************************************/
+#include "rml/RadeonML.hpp"
+#include "rml/RadeonML_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+/*
+ * Model instance with its own input and output tensors
+ */
+struct ModelInstance
+{
+    rml::Model model;
+    std::vector<rml::Tensor> inputs;
+    rml::Tensor output;
+    double prepare_ms = 0;
+};
+
+/*
+ * Fill tensor elements with a value
+ *
+ * @param tensor - tensor to fill
+ * @param value - element value in the tensor data type
+ */
+template<typename T>
+void FillTensor(const rml::Tensor& tensor, T value)
+{
+    rml::MappedTensor<T> data(tensor);
+    std::fill(data.begin(), data.end(), value);
+    data.Unmap();
+}
+
+/*
+ * Fill an input tensor with 0.5 in its data type
+ *
+ * @param tensor - tensor to fill
+ * @param dtype - tensor data type
+ */
+void FillInput(const rml::Tensor& tensor, rml_dtype dtype)
+{
+    switch (dtype)
+    {
+    case RML_DTYPE_FLOAT32:
+        FillTensor<float>(tensor, 0.5f);
+        break;
+    case RML_DTYPE_FLOAT16:
+        FillTensor<uint16_t>(tensor, 0x3800); // 0.5 in half precision
+        break;
+    case RML_DTYPE_UINT8:
+        FillTensor<uint8_t>(tensor, 128);
+        break;
+    case RML_DTYPE_INT32:
+        FillTensor<int32_t>(tensor, 1);
+        break;
+    default:
+        throw std::runtime_error("Unsupported input data type");
+    }
+}
+
+/*
+ * Create a model instance with all image inputs resized
+ *
+ * @param context - context where the model is created
+ * @param graph - model graph
+ * @param batch, height, width - input image dimensions
+ * @return - prepared model instance
+ */
+ModelInstance CreateInstance(const rml::Context& context,
+                             const rml::Graph& graph,
+                             uint32_t batch,
+                             uint32_t height,
+                             uint32_t width)
+{
+    ModelInstance instance = {context.CreateModel(graph)};
+
+    for (const char* name : graph.GetInputNames())
+    {
+        // Set unspecified input tensor dimensions
+        rml_tensor_info info = instance.model.GetInputInfo(name);
+        if (info.layout == RML_LAYOUT_NHWC)
+        {
+            info.shape[0] = batch;
+            info.shape[1] = height;
+            info.shape[2] = width;
+        }
+        else if (info.layout == RML_LAYOUT_NCHW)
+        {
+            info.shape[0] = batch;
+            info.shape[2] = height;
+            info.shape[3] = width;
+        }
+        else
+        {
+            throw std::runtime_error(std::string("Only NCHW or NHWC data layout is supported, ") +
+                                     "input " + name + " has another layout");
+        }
+        instance.model.SetInputInfo(name, info);
+
+        rml::Tensor input = context.CreateTensor(info, RML_ACCESS_MODE_WRITE_ONLY);
+        FillInput(input, info.dtype);
+
+        instance.model.SetInput(name, input);
+        instance.inputs.push_back(std::move(input));
+    }
+
+    instance.output =
+        context.CreateTensor(instance.model.GetOutputInfo(), RML_ACCESS_MODE_READ_ONLY);
+    instance.model.SetOutput(instance.output);
+
+    auto start = Clock::now();
+    instance.model.Prepare();
+    instance.prepare_ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return instance;
+}
+
+/*
+ * Get a percentile using the nearest-rank method
+ *
+ * @param sorted - sorted values
+ * @param percent - percentile in the range (0, 100]
+ * @return - percentile value
+ */
+double GetPercentile(const std::vector<double>& sorted, double percent)
+{
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * sorted.size()));
+    return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+}
+
+/*
+ * This benchmark runs inference of a model for a fixed duration from one or several threads,
+ * each with its own model instance, and reports latency percentiles and throughput
+ *
+ * Usage: bench_model [model] [batch] [height] [width] [duration_s] [concurrency]
+ */
+int main(int argc, char* argv[]) try
+{
+    // Set model path
+    const std::string model_path = argc > 1 ? argv[1] : "models/upscale2x_fast.pb";
+
+    // Set input dimensions and load parameters
+    const uint32_t batch = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 1;
+    const uint32_t height = argc > 3 ? std::atoi(argv[3]) : 540;
+    const uint32_t width = argc > 4 ? std::atoi(argv[4]) : 960;
+    const double duration_s = argc > 5 ? std::atof(argv[5]) : 10.0;
+    const size_t concurrency = argc > 6 ? std::max(std::atoi(argv[6]), 1) : 1;
+
+    // Create a context
+    rml::Context context = rml::CreateDefaultContext();
+
+    // Load model
+    auto load_start = Clock::now();
+    rml::Graph graph =
+        rml::LoadGraphFromFile(std::basic_string<rml_char>(model_path.begin(), model_path.end()));
+    const double load_ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - load_start).count();
+
+    // Create and prepare a model instance per thread
+    std::vector<ModelInstance> instances;
+    for (size_t i = 0; i < concurrency; i++)
+    {
+        instances.push_back(CreateInstance(context, graph, batch, height, width));
+    }
+
+    std::cout << "Model: " << model_path << "\n";
+    std::cout << "Input: " << instances[0].model.GetInputInfo(graph.GetInputNames()[0]) << "\n";
+    std::cout << "Output: " << instances[0].model.GetOutputInfo() << "\n";
+    std::cout << "Load time, ms: " << load_ms << "\n";
+    std::cout << "Prepare time, ms: " << instances[0].prepare_ms << "\n";
+    std::cout << "Memory allocated, bytes: " << instances[0].model.GetMemoryInfo().gpu_total
+              << " per instance\n";
+
+    // Warm up
+    for (const ModelInstance& instance : instances)
+    {
+        instance.model.Infer();
+    }
+
+    // Run inferences until the deadline
+    std::vector<double> latencies;
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::duration<double>(duration_s);
+
+    std::vector<std::thread> threads;
+    for (const ModelInstance& instance : instances)
+    {
+        threads.emplace_back([&] {
+            std::vector<double> thread_latencies;
+            try
+            {
+                while (Clock::now() < deadline)
+                {
+                    auto infer_start = Clock::now();
+                    instance.model.Infer();
+                    thread_latencies.push_back(
+                        std::chrono::duration<double, std::milli>(Clock::now() - infer_start)
+                            .count());
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = error ? error : std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            latencies.insert(latencies.end(), thread_latencies.begin(), thread_latencies.end());
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    if (latencies.empty())
+    {
+        throw std::runtime_error("No inference completed, increase the duration");
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "Concurrency: " << concurrency << "\n";
+    std::cout << "Inferences: " << latencies.size() << " in " << elapsed_s << " s\n";
+    std::cout << "Throughput, inferences/s: " << latencies.size() / elapsed_s << "\n";
+    std::cout << "Throughput, images/s: " << latencies.size() * batch / elapsed_s << "\n";
+    std::cout << "Latency, ms: min " << latencies.front() << ", p50 "
+              << GetPercentile(latencies, 50) << ", p90 " << GetPercentile(latencies, 90)
+              << ", p99 " << GetPercentile(latencies, 99) << ", p99.9 "
+              << GetPercentile(latencies, 99.9) << ", max " << latencies.back() << "\n";
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
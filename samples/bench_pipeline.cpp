@@ -0,0 +1,188 @@
+/*****************************************************************************
+Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*****************************************************************************/
+#include "rml/RadeonML.hpp"
+#include "rml/RadeonML_pipeline.hpp"
+#include "rml/RadeonML_utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Print pipeline statistics
+ *
+ * @param title - name of the run
+ * @param stats - pipeline statistics
+ */
+void PrintStats(const std::string& title, const rml::PipelineStats& stats)
+{
+    const double frames = static_cast<double>(stats.num_frames);
+    const double max_stage_ms =
+        std::max({stats.upload_ms, stats.infer_ms, stats.download_ms}) / frames;
+    const double frame_ms = stats.total_ms / frames;
+
+    std::cout << title << ":\n";
+    std::cout << "  upload, ms/frame:   " << stats.upload_ms / frames << "\n";
+    std::cout << "  infer, ms/frame:    " << stats.infer_ms / frames << "\n";
+    std::cout << "  download, ms/frame: " << stats.download_ms / frames << "\n";
+    std::cout << "  wall, ms/frame:     " << frame_ms << "\n";
+    std::cout << "  throughput, fps:    " << 1e3 / frame_ms << "\n";
+    std::cout << "  bound, fps:         " << 1e3 / max_stage_ms << " ("
+              << 100.0 * max_stage_ms / frame_ms << "% reached)\n";
+}
+
+/*
+ * Create a host frame filled with a value
+ *
+ * @param num_elements - number of frame elements
+ * @param value - element value
+ * @return - frame bytes
+ */
+template<class T>
+std::vector<uint8_t> CreateFrame(size_t num_elements, T value)
+{
+    std::vector<uint8_t> frame(num_elements * sizeof(T));
+    for (size_t i = 0; i < num_elements; i++)
+    {
+        std::memcpy(frame.data() + i * sizeof(T), &value, sizeof(T));
+    }
+    return frame;
+}
+
+/*
+ * Create a host input frame filled with 0.5 in the input data type
+ *
+ * @param info - input tensor info with all dimensions specified
+ * @return - frame bytes
+ */
+std::vector<uint8_t> CreateInputFrame(const rml_tensor_info& info)
+{
+    size_t num_elements = 1;
+    for (size_t i = 0; i < rml::GetLayoutNumDims(info.layout); i++)
+    {
+        num_elements *= info.shape[i];
+    }
+
+    switch (info.dtype)
+    {
+    case RML_DTYPE_FLOAT32:
+        return CreateFrame<float>(num_elements, 0.5f);
+    case RML_DTYPE_FLOAT16:
+        return CreateFrame<uint16_t>(num_elements, 0x3800); // 0.5 in half precision
+    case RML_DTYPE_UINT8:
+        return CreateFrame<uint8_t>(num_elements, 128);
+    case RML_DTYPE_INT32:
+        return CreateFrame<int32_t>(num_elements, 1);
+    default:
+        throw std::runtime_error("Unsupported input data type");
+    }
+}
+
+/*
+ * This benchmark compares serialized upload/infer/download of frames
+ * with the rml::Pipeline running the stages concurrently
+ *
+ * Usage: bench_pipeline [model] [height] [width] [num_frames] [depth]
+ */
+int main(int argc, char* argv[]) try
+{
+    // Set model path
+    const std::string model_path = argc > 1 ? argv[1] : "models/upscale2x_fast.pb";
+
+    // Set input spatial size, number of frames and pipeline depth
+    const uint32_t height = argc > 2 ? std::atoi(argv[2]) : 540;
+    const uint32_t width = argc > 3 ? std::atoi(argv[3]) : 960;
+    const size_t num_frames = argc > 4 ? std::max(std::atoi(argv[4]), 1) : 100;
+    const size_t depth = argc > 5 ? std::max(std::atoi(argv[5]), 2) : 3;
+
+    // Create a context
+    rml::Context context = rml::CreateDefaultContext();
+
+    // Load model
+    rml::Graph graph =
+        rml::LoadGraphFromFile(std::basic_string<rml_char>(model_path.begin(), model_path.end()));
+    rml::Model model = context.CreateModel(graph);
+
+    std::vector<const char*> input_names = graph.GetInputNames();
+    if (input_names.size() != 1)
+    {
+        throw std::runtime_error("Only models with a single input are supported");
+    }
+
+    // Set unspecified input tensor dimensions
+    rml_tensor_info input_info = model.GetInputInfo(input_names[0]);
+    if (input_info.layout == RML_LAYOUT_NHWC)
+    {
+        input_info.shape[0] = 1;
+        input_info.shape[1] = height;
+        input_info.shape[2] = width;
+    }
+    else if (input_info.layout == RML_LAYOUT_NCHW)
+    {
+        input_info.shape[0] = 1;
+        input_info.shape[2] = height;
+        input_info.shape[3] = width;
+    }
+    else
+    {
+        throw std::runtime_error("Only NCHW or NHWC data layout is supported");
+    }
+    model.SetInputInfo(input_names[0], input_info);
+    std::cout << "Model: " << model_path << "\n";
+    std::cout << "Input: " << input_info << "\n";
+    std::cout << "Output: " << model.GetOutputInfo() << "\n";
+
+    // Host frames
+    const std::vector<uint8_t> input_data = CreateInputFrame(input_info);
+    std::vector<uint8_t> output_data;
+
+    auto upload = [&](size_t, const std::vector<rml::Tensor>& inputs) {
+        inputs[0].Write(input_data);
+    };
+    auto download = [&](size_t, const std::vector<rml::Tensor>& outputs) {
+        outputs[0].Read(output_data);
+    };
+
+    const std::vector<std::string> inputs = {input_names[0]};
+    const std::vector<std::string> outputs = {""};
+
+    // Warm up
+    rml::Pipeline(context, model, inputs, outputs, 1).Run(1, upload, download);
+
+    // A single tensor set serializes the stages
+    PrintStats("Serialized",
+               rml::Pipeline(context, model, inputs, outputs, 1).Run(num_frames, upload, download));
+
+    PrintStats("Pipelined, depth " + std::to_string(depth),
+               rml::Pipeline(context, model, inputs, outputs, depth)
+                   .Run(num_frames, upload, download));
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
@@ -0,0 +1,968 @@
+/*****************************************************************************
+Copyright (c) 2020 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*****************************************************************************/
+#include "rml/RadeonML.hpp"
+#include "rml/RadeonML_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Benchmark configuration: data type, layout and image dimensions
+ */
+struct BenchConfig
+{
+    rml_dtype dtype;
+    rml_layout layout;
+    uint32_t n, h, w, c;
+};
+
+/*
+ * Single-operation graph along with the work it performs
+ */
+struct BenchGraph
+{
+    rml::Graph graph;
+    double num_flops = 0; // Zero for memory-bound operations
+    double num_bytes = 0; // Bytes read and written
+};
+
+/*
+ * Benchmark case: operation name, type and graph builder
+ */
+struct BenchCase
+{
+    std::string name;
+    rml_op_type op_type;
+    std::function<BenchGraph(rml_op_type, const BenchConfig&)> build;
+    bool layout_independent;
+};
+
+/*
+ * Get size of a tensor element
+ *
+ * @param dtype - tensor data type
+ * @return - element size in bytes
+ */
+size_t GetDTypeSize(rml_dtype dtype)
+{
+    switch (dtype)
+    {
+    case RML_DTYPE_FLOAT16:
+        return 2;
+    case RML_DTYPE_UINT8:
+        return 1;
+    default:
+        return 4;
+    }
+}
+
+/*
+ * Get number of tensor elements
+ *
+ * @param info - tensor description
+ * @return - number of elements
+ */
+size_t GetNumElements(const rml_tensor_info& info)
+{
+    size_t num_elements = 1;
+    for (size_t i = 0; i < rml::GetLayoutNumDims(info.layout); i++)
+    {
+        num_elements *= info.shape[i];
+    }
+    return num_elements;
+}
+
+/*
+ * Make an image tensor description in the configured layout
+ *
+ * @param config - benchmark configuration
+ * @param n, h, w, c - image dimensions
+ * @return - tensor description
+ */
+rml_tensor_info MakeImageInfo(const BenchConfig& config,
+                              uint32_t n,
+                              uint32_t h,
+                              uint32_t w,
+                              uint32_t c)
+{
+    rml_tensor_info info = {config.dtype, config.layout};
+    if (config.layout == RML_LAYOUT_NCHW)
+    {
+        info.shape[0] = n;
+        info.shape[1] = c;
+        info.shape[2] = h;
+        info.shape[3] = w;
+    }
+    else
+    {
+        info.shape[0] = n;
+        info.shape[1] = h;
+        info.shape[2] = w;
+        info.shape[3] = c;
+    }
+    return info;
+}
+
+/*
+ * Make tensor data filled with a value
+ *
+ * @param num_elements - number of elements
+ * @param value - element value
+ * @return - raw tensor data
+ */
+template<class T>
+std::vector<uint8_t> MakeUniformData(size_t num_elements, T value)
+{
+    std::vector<uint8_t> data(num_elements * sizeof(T));
+    for (size_t i = 0; i < num_elements; i++)
+    {
+        std::memcpy(&data[i * sizeof(T)], &value, sizeof(T));
+    }
+    return data;
+}
+
+/*
+ * Make tensor data filled with a small positive value
+ *
+ * @param dtype - tensor data type
+ * @param num_elements - number of elements
+ * @return - raw tensor data
+ */
+std::vector<uint8_t> MakeData(rml_dtype dtype, size_t num_elements)
+{
+    switch (dtype)
+    {
+    case RML_DTYPE_FLOAT32:
+        return MakeUniformData<float>(num_elements, 0.01f);
+    case RML_DTYPE_FLOAT16:
+        return MakeUniformData<uint16_t>(num_elements, 0x211f); // 0.01 in half precision
+    case RML_DTYPE_INT32:
+        return MakeUniformData<int32_t>(num_elements, 1);
+    case RML_DTYPE_UINT8:
+        return MakeUniformData<uint8_t>(num_elements, 1);
+    default:
+        throw std::runtime_error("Unsupported data type");
+    }
+}
+
+/*
+ * Create placeholder operation
+ *
+ * @param graph - graph where operation is created
+ * @param name - unique operation name
+ * @param info - input tensor description
+ * @return - created placeholder operation
+ */
+rml_op CreatePlaceholderOp(rml::Graph& graph, const char* name, const rml_tensor_info& info)
+{
+    rml_op_desc desc = {RML_OP_PLACEHOLDER, name};
+    desc.placeholder = {info};
+    return graph.CreateOperation(desc);
+}
+
+/*
+ * Create constant operation filled with a small positive value
+ *
+ * @param graph - graph where operation is created
+ * @param name - unique operation name
+ * @param info - constant tensor description
+ * @return - created constant operation
+ */
+rml_op CreateConstOp(rml::Graph& graph, const char* name, const rml_tensor_info& info)
+{
+    std::vector<uint8_t> data = MakeData(info.dtype, GetNumElements(info));
+    rml_op_desc desc = {RML_OP_CONST, name};
+    desc.constant = {info, data.data()};
+    return graph.CreateOperation(desc);
+}
+
+/*
+ * Get image size in bytes
+ */
+double GetImageBytes(const BenchConfig& config)
+{
+    return static_cast<double>(config.n) * config.h * config.w * config.c *
+           GetDTypeSize(config.dtype);
+}
+
+/*
+ * Build element-wise unary operation graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildUnary(rml_op_type op_type, const BenchConfig& config)
+{
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_desc desc = {op_type, "op"};
+    desc.unary = {CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c))};
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 2 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build element-wise binary operation graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildBinary(rml_op_type op_type, const BenchConfig& config)
+{
+    BenchGraph result = {rml::CreateGraph()};
+    const rml_tensor_info info = MakeImageInfo(config, config.n, config.h, config.w, config.c);
+    rml_op_desc desc = {op_type, "op"};
+    desc.binary = {CreatePlaceholderOp(result.graph, "input1", info),
+                   CreatePlaceholderOp(result.graph, "input2", info)};
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 3 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build 2D convolution graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildConv2D(rml_op_type op_type, const BenchConfig& config)
+{
+    // 3x3 convolution with the same number of input and output channels
+    const bool depthwise = op_type == RML_OP_CONV_2D_DEPTHWISE;
+    const uint32_t in_channels = depthwise ? 1 : config.c;
+
+    BenchGraph result = {rml::CreateGraph()};
+    rml_tensor_info weights_info = {config.dtype, RML_LAYOUT_OIHW, {config.c, in_channels, 3, 3}};
+    if (config.layout == RML_LAYOUT_NHWC)
+    {
+        weights_info = {config.dtype, RML_LAYOUT_HWIO, {3, 3, in_channels, config.c}};
+    }
+
+    rml_op_conv_2d_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.weights = CreateConstOp(result.graph, "weights", weights_info);
+    params.padding_type = RML_PADDING_SAME;
+
+    rml_op_desc desc = {op_type, "op"};
+    if (depthwise)
+    {
+        desc.conv_2d_depthwise = params;
+    }
+    else
+    {
+        desc.conv_2d = params;
+    }
+    result.graph.CreateOperation(desc);
+
+    result.num_flops = 2.0 * config.n * config.h * config.w * config.c * in_channels * 9;
+    result.num_bytes = 2 * GetImageBytes(config) +
+                       static_cast<double>(GetNumElements(weights_info)) *
+                           GetDTypeSize(config.dtype);
+    return result;
+}
+
+/*
+ * Build 2D pooling graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildPool2D(rml_op_type op_type, const BenchConfig& config)
+{
+    // 2x2 pooling with stride 2
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_pool_2d_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.padding_type = RML_PADDING_VALID;
+    params.kernel_size = {2, 2};
+    params.strides = {2, 2};
+
+    rml_op_desc desc = {op_type, "op"};
+    if (op_type == RML_OP_POOL_2D_MAX)
+    {
+        desc.pool_2d_max = params;
+    }
+    else
+    {
+        desc.pool_2d_avg = params;
+    }
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 1.25 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build global 2D pooling graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildGlobalPool2D(rml_op_type op_type, const BenchConfig& config)
+{
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_desc desc = {op_type, "op"};
+    desc.pool_2d_global_avg = {CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c))};
+    result.graph.CreateOperation(desc);
+    result.num_bytes = GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build depth to space or space to depth graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildDepthSpace(rml_op_type op_type, const BenchConfig& config)
+{
+    BenchGraph result = {rml::CreateGraph()};
+    const rml_op input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+
+    rml_op_desc desc = {op_type, "op"};
+    if (op_type == RML_OP_SPACE_TO_DEPTH)
+    {
+        desc.space_to_depth = {input, 2};
+    }
+    else
+    {
+        desc.depth_to_space = {input, 2};
+    }
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 2 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build reduction graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildReduce(rml_op_type op_type, const BenchConfig& config)
+{
+    // Reduction over channels
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_reduce_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.keep_dims = RML_TRUE;
+    params.num_axes = 1;
+    params.axes[0] = config.layout == RML_LAYOUT_NCHW ? 1 : 3;
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.reduce_add = params;
+    result.graph.CreateOperation(desc);
+    result.num_bytes = GetImageBytes(config) * (1.0 + 1.0 / config.c);
+    return result;
+}
+
+/*
+ * Build matrix multiplication graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildGemm(rml_op_type op_type, const BenchConfig& config)
+{
+    // Matrix product equivalent to 1x1 convolution: (N*H*W x C) * (C x C)
+    const uint32_t m = config.n * config.h * config.w;
+
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_gemm_params params = {};
+    params.input_a =
+        CreatePlaceholderOp(result.graph, "input", {config.dtype, RML_LAYOUT_NC, {m, config.c}});
+    params.input_b =
+        CreateConstOp(result.graph, "weights", {config.dtype, RML_LAYOUT_NC, {config.c, config.c}});
+    params.alpha = RML_OP_GEMM_DEFAULT_ALPHA;
+    params.beta = RML_OP_GEMM_DEFAULT_BETA;
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.gemm = params;
+    result.graph.CreateOperation(desc);
+
+    result.num_flops = 2.0 * m * config.c * config.c;
+    result.num_bytes = 2 * GetImageBytes(config) +
+                       static_cast<double>(config.c) * config.c * GetDTypeSize(config.dtype);
+    return result;
+}
+
+/*
+ * Build element-wise activation graph with parameters
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildActivation(rml_op_type op_type, const BenchConfig& config)
+{
+    BenchGraph result = {rml::CreateGraph()};
+    const rml_op input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+
+    // Default parameters of the corresponding ONNX operators
+    rml_op_desc desc = {op_type, "op"};
+    switch (op_type)
+    {
+    case RML_OP_CELU:
+        desc.celu = {input, 1.0f};
+        break;
+    case RML_OP_CLIP:
+        desc.clip = {input, 0.0f, 6.0f};
+        break;
+    case RML_OP_ELU:
+        desc.elu = {input, 1.0f};
+        break;
+    case RML_OP_LEAKY_RELU:
+        desc.leaky_relu = {input, 0.01f};
+        break;
+    case RML_OP_SELU:
+        desc.selu = {input, 1.67326f, 1.0507f};
+        break;
+    case RML_OP_THRESHOLDED_RELU:
+        desc.thresholded_relu = {input, 1.0f};
+        break;
+    default:
+        throw std::runtime_error("Unsupported activation");
+    }
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 2 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build batch normalization graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildBatchNorm(rml_op_type op_type, const BenchConfig& config)
+{
+    BenchGraph result = {rml::CreateGraph()};
+    const rml_tensor_info channel_info = {config.dtype, RML_LAYOUT_C, {config.c}};
+
+    rml_op_batch_norm_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.mean = CreateConstOp(result.graph, "mean", channel_info);
+    params.variance = CreateConstOp(result.graph, "variance", channel_info);
+    params.scale = CreateConstOp(result.graph, "scale", channel_info);
+    params.bias = CreateConstOp(result.graph, "bias", channel_info);
+    params.epsilon = 1e-5f;
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.batch_norm = params;
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 2 * GetImageBytes(config) + 4.0 * config.c * GetDTypeSize(config.dtype);
+    return result;
+}
+
+/*
+ * Build bias addition graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildBiasAdd(rml_op_type op_type, const BenchConfig& config)
+{
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_desc desc = {op_type, "op"};
+    desc.bias_add = {
+        CreatePlaceholderOp(
+            result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c)),
+        CreateConstOp(result.graph, "bias", {config.dtype, RML_LAYOUT_C, {config.c}})};
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 2 * GetImageBytes(config) + 1.0 * config.c * GetDTypeSize(config.dtype);
+    return result;
+}
+
+/*
+ * Build padding graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildPad(rml_op_type op_type, const BenchConfig& config)
+{
+    // Constant padding by one pixel on each side
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_pad_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.mode = RML_PAD_MODE_CONSTANT;
+    params.num_dims = 4;
+    const size_t h_axis = config.layout == RML_LAYOUT_NCHW ? 2 : 1;
+    for (size_t axis : {h_axis, h_axis + 1})
+    {
+        params.start_padding[axis] = 1;
+        params.end_padding[axis] = 1;
+    }
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.pad = params;
+    result.graph.CreateOperation(desc);
+
+    BenchConfig padded = config;
+    padded.h += 2;
+    padded.w += 2;
+    result.num_bytes = GetImageBytes(config) + GetImageBytes(padded);
+    return result;
+}
+
+/*
+ * Build transposed 2D convolution graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildConv2DTranspose(rml_op_type op_type, const BenchConfig& config)
+{
+    // 3x3 upsampling by 2 with the same number of input and output channels
+    BenchGraph result = {rml::CreateGraph()};
+    rml_tensor_info weights_info = {config.dtype, RML_LAYOUT_OIHW, {config.c, config.c, 3, 3}};
+    if (config.layout == RML_LAYOUT_NHWC)
+    {
+        weights_info = {config.dtype, RML_LAYOUT_HWIO, {3, 3, config.c, config.c}};
+    }
+
+    rml_op_conv_2d_transpose_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.weights = CreateConstOp(result.graph, "weights", weights_info);
+    params.padding_type = RML_PADDING_SAME;
+    params.strides = {2, 2};
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.conv_2d_transpose = params;
+    result.graph.CreateOperation(desc);
+
+    result.num_flops = 2.0 * config.n * config.h * config.w * config.c * config.c * 9;
+    result.num_bytes = 5 * GetImageBytes(config) +
+                       static_cast<double>(GetNumElements(weights_info)) *
+                           GetDTypeSize(config.dtype);
+    return result;
+}
+
+/*
+ * Build transpose graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildTranspose(rml_op_type op_type, const BenchConfig& config)
+{
+    // Conversion to the other image layout
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_transpose_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.num_axes = 4;
+    const int32_t nhwc_to_nchw[] = {0, 3, 1, 2};
+    const int32_t nchw_to_nhwc[] = {0, 2, 3, 1};
+    const int32_t* axes = config.layout == RML_LAYOUT_NCHW ? nchw_to_nhwc : nhwc_to_nchw;
+    std::copy(axes, axes + 4, params.axes);
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.transpose = params;
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 2 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build concatenation graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildConcat(rml_op_type op_type, const BenchConfig& config)
+{
+    // Concatenation of two images along channels
+    BenchGraph result = {rml::CreateGraph()};
+    const rml_tensor_info info = MakeImageInfo(config, config.n, config.h, config.w, config.c);
+    rml_op inputs[] = {CreatePlaceholderOp(result.graph, "input1", info),
+                       CreatePlaceholderOp(result.graph, "input2", info)};
+
+    const int32_t axis = config.layout == RML_LAYOUT_NCHW ? 1 : 3;
+    rml_op_desc axis_desc = {RML_OP_CONST, "axis"};
+    axis_desc.constant = {{RML_DTYPE_INT32, RML_LAYOUT_SCALAR}, &axis};
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.concat = {2, inputs, result.graph.CreateOperation(axis_desc)};
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 4 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Build cast graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildCast(rml_op_type op_type, const BenchConfig& config)
+{
+    // Conversion between float32 and float16
+    const rml_dtype cast_to =
+        config.dtype == RML_DTYPE_FLOAT32 ? RML_DTYPE_FLOAT16 : RML_DTYPE_FLOAT32;
+
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_desc desc = {op_type, "op"};
+    desc.cast = {CreatePlaceholderOp(result.graph,
+                                     "input",
+                                     MakeImageInfo(config, config.n, config.h, config.w, config.c)),
+                 cast_to};
+    result.graph.CreateOperation(desc);
+    result.num_bytes =
+        GetImageBytes(config) * (1.0 + static_cast<double>(GetDTypeSize(cast_to)) /
+                                           GetDTypeSize(config.dtype));
+    return result;
+}
+
+/*
+ * Build local response normalization graph
+ *
+ * @param op_type - operation type
+ * @param config - benchmark configuration
+ * @return - graph and its amount of work
+ */
+BenchGraph BuildLocalResponseNorm(rml_op_type op_type, const BenchConfig& config)
+{
+    // Cross channel normalization with the AlexNet parameters
+    BenchGraph result = {rml::CreateGraph()};
+    rml_op_local_response_norm_params params = {};
+    params.input = CreatePlaceholderOp(
+        result.graph, "input", MakeImageInfo(config, config.n, config.h, config.w, config.c));
+    params.size = 5;
+    params.alpha = 1e-4f;
+    params.beta = 0.75f;
+    params.bias = 1.0f;
+    params.cross_channel = RML_TRUE;
+
+    rml_op_desc desc = {op_type, "op"};
+    desc.local_response_norm = params;
+    result.graph.CreateOperation(desc);
+    result.num_bytes = 2 * GetImageBytes(config);
+    return result;
+}
+
+/*
+ * Get list of benchmarked operations
+ *
+ * Operations which only describe the graph (placeholders, constants, ports, shapes),
+ * only change the shape (reshape, flatten, squeeze, unsqueeze, slice, stack)
+ * or take extra tensors with sizes or scales (resize, quantization, top-k) are not benchmarked.
+ */
+std::vector<BenchCase> GetBenchCases()
+{
+    std::vector<BenchCase> cases = {
+        {"conv_2d", RML_OP_CONV_2D, BuildConv2D, false},
+        {"conv_2d_depthwise", RML_OP_CONV_2D_DEPTHWISE, BuildConv2D, false},
+        {"conv_2d_transpose", RML_OP_CONV_2D_TRANSPOSE, BuildConv2DTranspose, false},
+        {"pool_2d_avg", RML_OP_POOL_2D_AVG, BuildPool2D, false},
+        {"pool_2d_max", RML_OP_POOL_2D_MAX, BuildPool2D, false},
+        {"pool_2d_global_avg", RML_OP_POOL_2D_GLOBAL_AVG, BuildGlobalPool2D, false},
+        {"depth_to_space", RML_OP_DEPTH_TO_SPACE, BuildDepthSpace, false},
+        {"space_to_depth", RML_OP_SPACE_TO_DEPTH, BuildDepthSpace, false},
+        {"gemm", RML_OP_GEMM, BuildGemm, true},
+        {"batch_norm", RML_OP_BATCH_NORM, BuildBatchNorm, false},
+        {"bias_add", RML_OP_BIAS_ADD, BuildBiasAdd, false},
+        {"local_response_norm", RML_OP_LOCAL_RESPONSE_NORM, BuildLocalResponseNorm, false},
+        {"pad", RML_OP_PAD, BuildPad, false},
+        {"transpose", RML_OP_TRANSPOSE, BuildTranspose, false},
+        {"concat", RML_OP_CONCAT, BuildConcat, false},
+        {"cast", RML_OP_CAST, BuildCast, true},
+    };
+
+    const std::vector<std::pair<std::string, rml_op_type>> reduce_ops = {
+        {"reduce_add", RML_OP_REDUCE_ADD},
+        {"reduce_add_square", RML_OP_REDUCE_ADD_SQUARE},
+        {"reduce_argmax", RML_OP_REDUCE_ARGMAX},
+        {"reduce_argmin", RML_OP_REDUCE_ARGMIN},
+        {"reduce_avg", RML_OP_REDUCE_AVG},
+        {"reduce_l1", RML_OP_REDUCE_L1},
+        {"reduce_l2", RML_OP_REDUCE_L2},
+        {"reduce_logn_add", RML_OP_REDUCE_LOGN_ADD},
+        {"reduce_logn_add_exp", RML_OP_REDUCE_LOGN_ADD_EXP},
+        {"reduce_max", RML_OP_REDUCE_MAX},
+        {"reduce_min", RML_OP_REDUCE_MIN},
+        {"reduce_mul", RML_OP_REDUCE_MUL},
+    };
+    for (const auto& op : reduce_ops)
+    {
+        cases.push_back({op.first, op.second, BuildReduce, false});
+    }
+
+    const std::vector<std::pair<std::string, rml_op_type>> binary_ops = {
+        {"add", RML_OP_ADD},
+        {"avg", RML_OP_AVG},
+        {"div", RML_OP_DIV},
+        {"max", RML_OP_MAX},
+        {"min", RML_OP_MIN},
+        {"mul", RML_OP_MUL},
+        {"parametric_relu", RML_OP_PARAMETRIC_RELU},
+        {"pow", RML_OP_POW},
+        {"sub", RML_OP_SUB},
+    };
+    for (const auto& op : binary_ops)
+    {
+        cases.push_back({op.first, op.second, BuildBinary, true});
+    }
+
+    const std::vector<std::pair<std::string, rml_op_type>> unary_ops = {
+        {"abs", RML_OP_ABS},
+        {"acos", RML_OP_ACOS},
+        {"asin", RML_OP_ASIN},
+        {"atan", RML_OP_ATAN},
+        {"ceil", RML_OP_CEIL},
+        {"cos", RML_OP_COS},
+        {"exp", RML_OP_EXP},
+        {"floor", RML_OP_FLOOR},
+        {"identity", RML_OP_IDENTITY},
+        {"log_softmax", RML_OP_LOG_SOFTMAX},
+        {"logn", RML_OP_LOGN},
+        {"neg", RML_OP_NEG},
+        {"recip", RML_OP_RECIP},
+        {"relu", RML_OP_RELU},
+        {"relu6", RML_OP_RELU6},
+        {"rsqrt", RML_OP_RSQRT},
+        {"sigmoid", RML_OP_SIGMOID},
+        {"sin", RML_OP_SIN},
+        {"softmax", RML_OP_SOFTMAX},
+        {"softplus", RML_OP_SOFTPLUS},
+        {"softsign", RML_OP_SOFTSIGN},
+        {"sqrt", RML_OP_SQRT},
+        {"tan", RML_OP_TAN},
+        {"tanh", RML_OP_TANH},
+    };
+    for (const auto& op : unary_ops)
+    {
+        // Softmax depends on the channel axis position
+        const bool softmax = op.second == RML_OP_SOFTMAX || op.second == RML_OP_LOG_SOFTMAX;
+        cases.push_back({op.first, op.second, BuildUnary, !softmax});
+    }
+
+    const std::vector<std::pair<std::string, rml_op_type>> activation_ops = {
+        {"celu", RML_OP_CELU},
+        {"clip", RML_OP_CLIP},
+        {"elu", RML_OP_ELU},
+        {"leaky_relu", RML_OP_LEAKY_RELU},
+        {"selu", RML_OP_SELU},
+        {"thresholded_relu", RML_OP_THRESHOLDED_RELU},
+    };
+    for (const auto& op : activation_ops)
+    {
+        cases.push_back({op.first, op.second, BuildActivation, true});
+    }
+
+    return cases;
+}
+
+/*
+ * Run inference of a single-operation graph
+ *
+ * @param context - context where the model is created
+ * @param graph - graph to benchmark
+ * @param num_warmup - number of untimed inferences
+ * @param num_iterations - number of timed inferences
+ * @return - sorted inference times in milliseconds
+ */
+std::vector<double> TimeInference(const rml::Context& context,
+                                  const rml::Graph& graph,
+                                  int num_warmup,
+                                  int num_iterations)
+{
+    rml::Model model = context.CreateModel(graph);
+
+    std::vector<rml::Tensor> inputs;
+    for (const char* name : graph.GetInputNames())
+    {
+        const rml_tensor_info info = model.GetInputInfo(name);
+        rml::Tensor input = context.CreateTensor(info, RML_ACCESS_MODE_WRITE_ONLY);
+        input.Write(MakeData(info.dtype, GetNumElements(info)));
+        model.SetInput(name, input);
+        inputs.push_back(std::move(input));
+    }
+
+    rml::Tensor output = context.CreateTensor(model.GetOutputInfo(), RML_ACCESS_MODE_READ_ONLY);
+    model.SetOutput(output);
+    model.Prepare();
+
+    for (int i = 0; i < num_warmup; i++)
+    {
+        model.Infer();
+    }
+
+    std::vector<double> times;
+    for (int i = 0; i < num_iterations; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        model.Infer();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times;
+}
+
+/*
+ * Escape a string for JSON output
+ */
+std::string EscapeJson(const std::string& str)
+{
+    std::string result;
+    for (char ch : str)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            result += '\\';
+            result += ch;
+        }
+        else if (static_cast<unsigned char>(ch) < 0x20)
+        {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+            result += buffer;
+        }
+        else
+        {
+            result += ch;
+        }
+    }
+    return result;
+}
+
+/*
+ * This benchmark times single-operation graphs over a sweep of shapes, data types and
+ * layouts and prints the results as a JSON array to stdout
+ *
+ * Usage: rml_bench [op_name|all] [num_warmup] [num_iterations]
+ */
+int main(int argc, char* argv[]) try
+{
+    const std::string op_filter = argc > 1 ? argv[1] : "all";
+    const int num_warmup = argc > 2 ? std::max(std::atoi(argv[2]), 0) : 5;
+    const int num_iterations = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 20;
+
+    const std::vector<rml_dtype> dtypes = {RML_DTYPE_FLOAT32, RML_DTYPE_FLOAT16};
+    const std::vector<rml_layout> layouts = {RML_LAYOUT_NHWC, RML_LAYOUT_NCHW};
+    const std::vector<std::vector<uint32_t>> shapes = {
+        {1, 128, 128, 64},
+        {1, 256, 256, 32},
+        {1, 540, 960, 16},
+    };
+
+    // Create a context
+    rml::Context context = rml::CreateDefaultContext();
+
+    std::ostringstream records;
+    for (const BenchCase& bench_case : GetBenchCases())
+    {
+        if (op_filter != "all" && op_filter != bench_case.name)
+        {
+            continue;
+        }
+
+        for (rml_dtype dtype : dtypes)
+        {
+            for (rml_layout layout : layouts)
+            {
+                if (bench_case.layout_independent && layout != layouts.front())
+                {
+                    continue;
+                }
+
+                for (const auto& shape : shapes)
+                {
+                    const BenchConfig config = {
+                        dtype, layout, shape[0], shape[1], shape[2], shape[3]};
+
+                    std::ostringstream record;
+                    record << "{\"op\": \"" << bench_case.name << "\", \"dtype\": \"" << dtype
+                           << "\", \"layout\": \"" << layout << "\", \"shape\": [" << shape[0]
+                           << ", " << shape[1] << ", " << shape[2] << ", " << shape[3] << "]";
+
+                    try
+                    {
+                        BenchGraph bench_graph = bench_case.build(bench_case.op_type, config);
+                        std::vector<double> times =
+                            TimeInference(context, bench_graph.graph, num_warmup, num_iterations);
+                        const double median_ms = times[times.size() / 2];
+
+                        record << ", \"min_ms\": " << times.front()
+                               << ", \"median_ms\": " << median_ms;
+                        if (bench_graph.num_flops > 0)
+                        {
+                            record << ", \"gflops\": " << bench_graph.num_flops / median_ms * 1e-6;
+                        }
+                        record << ", \"gbps\": " << bench_graph.num_bytes / median_ms * 1e-6;
+                    }
+                    catch (const std::exception& e)
+                    {
+                        // Unsupported operations are reported and skipped
+                        record << ", \"error\": \"" << EscapeJson(e.what()) << "\"";
+                    }
+                    record << "}";
+
+                    std::cerr << record.str() << std::endl;
+                    records << (records.tellp() > 0 ? ",\n  " : "[\n  ") << record.str();
+                }
+            }
+        }
+    }
+
+    std::cout << (records.tellp() > 0 ? records.str() + "\n]" : "[]") << std::endl;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return 1;
+}